@@ -54,19 +54,19 @@ bool hash::init_from_file( const std::string& file )
   if ( !mp.init() ) {
     return false;
   }
-  pc::dec_base58( (const uint8_t*)mp.data(), mp.size(), pk_ );
+  pc::dec_base58_fixed<len>( (const uint8_t*)mp.data(), mp.size(), pk_ );
   return true;
 }
 
 bool hash::init_from_text( const std::string& buf )
 {
-  pc::dec_base58( (const uint8_t*)buf.c_str(), buf.length(), pk_ );
+  pc::dec_base58_fixed<len>( (const uint8_t*)buf.c_str(), buf.length(), pk_ );
   return true;
 }
 
 bool hash::init_from_text( str buf )
 {
-  pc::dec_base58( (const uint8_t*)buf.str_, buf.len_, pk_ );
+  pc::dec_base58_fixed<len>( (const uint8_t*)buf.str_, buf.len_, pk_ );
   return true;
 }
 
@@ -77,7 +77,7 @@ void hash::init_from_buf( const uint8_t *pk )
 
 int hash::enc_base58( uint8_t *buf, uint32_t buflen ) const
 {
-  return pc::enc_base58( pk_, len, buf, buflen );
+  return pc::enc_base58_fixed<len>( pk_, buf, buflen );
 }
 
 int hash::enc_base58( std::string& res ) const
@@ -90,7 +90,7 @@ int hash::enc_base58( std::string& res ) const
 
 int hash::dec_base58( const uint8_t *buf, uint32_t buflen )
 {
-  return pc::dec_base58( buf, buflen, pk_ );
+  return pc::dec_base58_fixed<len>( buf, buflen, pk_ );
 }
 
 pub_key::pub_key()
@@ -112,6 +112,31 @@ pub_key& pub_key::operator=( const pub_key& pk )
   return (pub_key&)hash::operator=( pk );
 }
 
+pub_key_b58::pub_key_b58()
+: ck_(),
+  tlen_( 0 )
+{
+}
+
+pub_key_b58::pub_key_b58( const pub_key& pk )
+: pub_key( pk ),
+  ck_(),
+  tlen_( 0 )
+{
+}
+
+pub_key_b58& pub_key_b58::operator=( const pub_key& pk )
+{
+  pub_key::operator=( pk );
+  return *this;
+}
+
+void pub_key_b58::enc_text() const
+{
+  __builtin_memcpy( ck_, i_, sizeof( ck_ ) );
+  tlen_ = hash::enc_base58( (uint8_t*)txt_, sizeof( txt_ ) );
+}
+
 void key_pair::gen()
 {
   EVP_PKEY *pkey = NULL;
@@ -193,13 +218,13 @@ void signature::init_from_buf( const uint8_t *buf )
 
 bool signature::init_from_text( const std::string& buf )
 {
-  pc::dec_base58( (const uint8_t*)buf.c_str(), buf.length(), sig_ );
+  pc::dec_base58_fixed<len>( (const uint8_t*)buf.c_str(), buf.length(), sig_ );
   return true;
 }
 
 int signature::enc_base58( uint8_t *buf, uint32_t buflen )
 {
-  return pc::enc_base58( sig_, len, buf, buflen );
+  return pc::enc_base58_fixed<len>( sig_, buf, buflen );
 }
 
 int signature::enc_base58( std::string& res )
@@ -46,6 +46,26 @@ namespace pc
     pub_key& operator=( const pub_key& );
   };
 
+  // public key of long-lived account with lazily computed and cached
+  // base58 text
+  class pub_key_b58 : public pub_key
+  {
+  public:
+    pub_key_b58();
+    pub_key_b58( const pub_key& );
+    pub_key_b58& operator=( const pub_key& );
+
+    // base58 text (re-encoded only if key has changed)
+    str get_text() const;
+
+  private:
+    void enc_text() const;
+
+    mutable uint64_t ck_[4];   // key that text was encoded from
+    mutable uint32_t tlen_;    // text length
+    mutable char     txt_[48]; // base58 text
+  };
+
   // private/public key pair
   class key_pair
   {
@@ -131,4 +151,13 @@ namespace pc
     return sig_;
   }
 
+  inline str pub_key_b58::get_text() const
+  {
+    if ( tlen_ == 0 || ck_[0] != i_[0] || ck_[1] != i_[1] ||
+         ck_[2] != i_[2] || ck_[3] != i_[3] ) {
+      enc_text();
+    }
+    return str( txt_, tlen_ );
+  }
+
 }
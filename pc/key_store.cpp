@@ -160,7 +160,7 @@ key_cache *key_store::get_publish_key_cache()
   }
 }
 
-pub_key *key_store::get_publish_pub_key()
+pub_key_b58 *key_store::get_publish_pub_key()
 {
   if ( has_pkey_ ) {
     return &ppub_;
@@ -197,7 +197,7 @@ key_pair *key_store::get_mapping_key_pair()
   return &mkey_;
 }
 
-pub_key *key_store::get_mapping_pub_key()
+pub_key_b58 *key_store::get_mapping_pub_key()
 {
   if ( has_mpub_ ) {
     return &mpub_;
@@ -238,7 +238,7 @@ key_pair *key_store::get_program_key_pair()
   return &gkey_;
 }
 
-pub_key *key_store::get_program_pub_key()
+pub_key_b58 *key_store::get_program_pub_key()
 {
   if ( has_gpub_ ) {
     return &gpub_;
@@ -34,17 +34,17 @@ namespace pc
     key_pair *create_publish_key_pair();
     key_pair *get_publish_key_pair();
     key_cache*get_publish_key_cache();
-    pub_key  *get_publish_pub_key();
+    pub_key_b58 *get_publish_pub_key();
 
     // get mapping key_pair or public key
     key_pair *create_mapping_key_pair();
     key_pair *get_mapping_key_pair();
-    pub_key  *get_mapping_pub_key();
+    pub_key_b58 *get_mapping_pub_key();
 
     // get program_id public key
     key_pair *create_program_key_pair();
     key_pair *get_program_key_pair();
-    pub_key  *get_program_pub_key();
+    pub_key_b58 *get_program_pub_key();
 
     // create new mapping or symbol account
     bool create_account_key_pair( key_pair& );
@@ -61,9 +61,9 @@ namespace pc
     key_pair    mkey_; // mapping account key
     key_pair    gkey_; // program key pair
     key_cache   ckey_; // publishing cache key
-    pub_key     ppub_; // publisher public key
-    pub_key     mpub_; // mapping account public key
-    pub_key     gpub_; // program id
+    pub_key_b58 ppub_; // publisher public key
+    pub_key_b58 mpub_; // mapping account public key
+    pub_key_b58 gpub_; // program id
     std::string dir_;  // key store directory
   };
 
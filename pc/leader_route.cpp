@@ -0,0 +1,159 @@
+#include "leader_route.hpp"
+#include <algorithm>
+
+#define PC_MISSING_LOG_RATE   4
+#define PC_MISSING_LOG_BURST  16
+#define PC_LEADER_BEHIND      1
+#define PC_LEADER_AHEAD       4
+
+using namespace pc;
+
+leader_route::leader_route()
+: slot_( 0UL ),
+  rslot_( 0UL ),
+  rbeg_( 0 ),
+  rend_( 0 ),
+  num_miss_( 0 ),
+  lbehind_( PC_LEADER_BEHIND ),
+  lahead_( PC_LEADER_AHEAD ),
+  mlim_( PC_MISSING_LOG_RATE, PC_MISSING_LOG_BURST )
+{
+}
+
+void leader_route::set_window( uint32_t behind, uint32_t ahead )
+{
+  lbehind_ = behind;
+  lahead_  = ahead;
+}
+
+uint32_t leader_route::get_behind() const
+{
+  return lbehind_;
+}
+
+uint32_t leader_route::get_ahead() const
+{
+  return lahead_;
+}
+
+uint64_t leader_route::get_slot() const
+{
+  return slot_;
+}
+
+uint64_t leader_route::get_first_slot() const
+{
+  return rslot_;
+}
+
+uint64_t leader_route::get_num_slot() const
+{
+  return lvec_.size();
+}
+
+uint32_t leader_route::get_num_addr() const
+{
+  return avec_.size();
+}
+
+uint32_t leader_route::get_num_missing() const
+{
+  return num_miss_;
+}
+
+void leader_route::reset()
+{
+  avec_.clear();
+  lvec_.clear();
+  rvec_.clear();
+  roff_.clear();
+  slot_ = rslot_ = 0UL;
+  rbeg_ = rend_ = 0;
+  num_miss_ = 0;
+}
+
+uint32_t leader_route::add_addr( const ip_addr& addr )
+{
+  for( uint32_t i = 0; i != avec_.size(); ++i ) {
+    if ( avec_[i] == addr ) return i;
+  }
+  avec_.push_back( addr );
+  return avec_.size() - 1;
+}
+
+void leader_route::build( rpc::get_slot_leaders *lreq,
+                          rpc::get_cluster_nodes *creq )
+{
+  // resolve address of each leader in schedule once
+  static const uint32_t no_addr = (uint32_t)-1;
+  uint64_t fslot = lreq->get_first_slot();
+  uint64_t lslot = lreq->get_last_slot();
+  avec_.clear();
+  lvec_.clear();
+  pub_key *pkey = nullptr;
+  uint32_t pidx = no_addr;
+  num_miss_ = 0;
+  ip_addr iaddr;
+  for( uint64_t slot = fslot; slot < lslot; ++slot ) {
+    pub_key *ikey = lreq->get_leader( slot );
+    if ( !ikey ) {
+      pidx = no_addr;
+    } else if ( !pkey || *ikey != *pkey ) {
+      if ( creq->get_ip_addr( *ikey, iaddr ) ) {
+        pidx = add_addr( iaddr );
+      } else {
+        pidx = no_addr;
+        ++num_miss_;
+        PC_LOG_WRN_LIMIT( "missing leader addr", mlim_ )
+          .add( "leader", *ikey )
+          .add( "slot", slot )
+          .add( "first_slot", fslot )
+          .add( "last_slot", lslot )
+          .end();
+      }
+    }
+    pkey = ikey;
+    lvec_.push_back( pidx );
+  }
+
+  // unique destinations of leaders within window of each slot
+  rvec_.clear();
+  roff_.clear();
+  uint64_t num_slot = lvec_.size();
+  for( uint64_t i = 0; i != num_slot; ++i ) {
+    uint32_t off = rvec_.size();
+    roff_.push_back( off );
+    uint64_t j = i > lbehind_ ? i - lbehind_ : 0;
+    uint64_t k = std::min( i + lahead_ + 1, num_slot );
+    for( ; j < k; ++j ) {
+      uint32_t idx = lvec_[j];
+      if ( idx != no_addr &&
+           std::find( rvec_.begin() + off, rvec_.end(), idx ) ==
+           rvec_.end() ) {
+        rvec_.push_back( idx );
+      }
+    }
+  }
+  roff_.push_back( rvec_.size() );
+  rslot_ = fslot;
+  set_slot( slot_ );
+  PC_LOG_DBG( "build leader route" )
+    .add( "first_slot", fslot )
+    .add( "num_slot", num_slot )
+    .add( "num_addr", avec_.size() )
+    .add( "num_missing", num_miss_ )
+    .end();
+}
+
+void leader_route::set_slot( uint64_t slot )
+{
+  // slots before or after the table have no destinations
+  slot_ = slot;
+  uint64_t idx = slot_ - rslot_;
+  if ( slot_ >= rslot_ && idx + 1 < roff_.size() ) {
+    rbeg_ = roff_[idx];
+    rend_ = roff_[idx+1];
+  } else {
+    rbeg_ = rend_ = 0;
+  }
+}
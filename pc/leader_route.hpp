@@ -0,0 +1,79 @@
+#pragma once
+
+#include <pc/rpc_client.hpp>
+#include <pc/log.hpp>
+
+namespace pc
+{
+
+  // transaction destinations by slot precomputed from the slot leader
+  // schedule. each slot maps to the unique tpu addresses of the leaders
+  // within a window of slots around it
+  class leader_route
+  {
+  public:
+
+    leader_route();
+
+    // number of slots before and after the current slot whose leaders
+    // receive each transaction (default 1 and 4)
+    void set_window( uint32_t behind, uint32_t ahead );
+    uint32_t get_behind() const;
+    uint32_t get_ahead() const;
+
+    // rebuild routing table from leader schedule and cluster addresses
+    void build( rpc::get_slot_leaders *, rpc::get_cluster_nodes * );
+
+    // discard routing table (e.g. on rpc reconnect)
+    void reset();
+
+    // switch to precomputed destinations of slot
+    void set_slot( uint64_t slot );
+    uint64_t get_slot() const;
+
+    // destinations of current slot
+    uint32_t get_num_dest() const;
+    ip_addr *get_dest( uint32_t i );
+
+    // first slot and number of slots in routing table
+    uint64_t get_first_slot() const;
+    uint64_t get_num_slot() const;
+
+    // number of unique leader addresses in schedule
+    uint32_t get_num_addr() const;
+
+    // number of leaders without address
+    uint32_t get_num_missing() const;
+
+  private:
+
+    typedef std::vector<ip_addr>  addr_vec_t;
+    typedef std::vector<uint32_t> idx_vec_t;
+
+    uint32_t add_addr( const ip_addr& );
+
+    addr_vec_t avec_;        // unique leader addresses in schedule
+    idx_vec_t  lvec_;        // address index of leader by slot
+    idx_vec_t  rvec_;        // destination address indices by slot
+    idx_vec_t  roff_;        // offset into rvec_ by slot
+    uint64_t   slot_;        // current slot
+    uint64_t   rslot_;       // first slot of routing table
+    uint32_t   rbeg_;        // current slot destinations begin
+    uint32_t   rend_;        // current slot destinations end
+    uint32_t   num_miss_;    // number of leaders without address
+    uint32_t   lbehind_;     // leader window before current slot
+    uint32_t   lahead_;      // leader window after current slot
+    log_limit  mlim_;        // missing leader log rate limit
+  };
+
+  inline uint32_t leader_route::get_num_dest() const
+  {
+    return rend_ - rbeg_;
+  }
+
+  inline ip_addr *leader_route::get_dest( uint32_t i )
+  {
+    return &avec_[rvec_[rbeg_ + i]];
+  }
+
+}
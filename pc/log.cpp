@@ -1,15 +1,39 @@
 #include "log.hpp"
 #include "misc.hpp"
 #include <unistd.h>
-#include <atomic>
+#include <fcntl.h>
+#include <sys/uio.h>
 #include <thread>
 #include <mutex>
-#include <fstream>
-#include <iostream>
+#include <vector>
+
+#define PC_LOG_OUT_BLOCKS     16
+#define PC_LOG_OUT_BLOCK_SIZE 16384
+#define PC_LOG_TOPIC_LEN      40
 
 namespace pc
 {
 
+  // argument types of binary log records
+  enum log_arg_t {
+    e_log_str = 0,
+    e_log_pkey,
+    e_log_i64,
+    e_log_u64,
+    e_log_f64
+  };
+
+  // binary log record header
+  struct log_hdr
+  {
+    uint32_t len_;       // total record length including header
+    uint32_t lvl_;       // log level
+    int64_t  ts_;        // timestamp in nanoseconds
+    uint8_t  tlen_;      // topic length followed by topic text
+  };
+
+  const size_t log_hdr_len = 17;
+
   class log_impl
   {
   public:
@@ -18,26 +42,73 @@ namespace pc
     void start();
     void stop();
     void run();
-    void add( net_wtr& wtr );
+    log_ring *get_ring();
     bool set_log_file( const std::string& );
 
   private:
-    typedef std::vector<net_buf*> buf_vec_t;
+    typedef std::vector<log_ring*> ring_vec_t;
     typedef std::atomic<bool> atomic_t;
-    atomic_t      is_run_;
-    atomic_t      is_wtr_;
-    std::mutex    mtx_;
-    std::thread   thrd_;
-    buf_vec_t     logv_;
-    buf_vec_t     reuse_;
-    std::ostream *strm_;
-    std::ofstream logf_;
+
+    bool drain( ring_vec_t& );
+    void format( const char *rec, size_t len );
+    void format_drop( uint64_t num );
+    void add_header( int64_t ts, uint32_t lvl, const char *topic, size_t );
+    void add( const char *, size_t );
+    void add( char );
+    void add_u64( uint64_t );
+    void add_i64( int64_t );
+    void add_f64( double );
+    void flush();
+
+    atomic_t     is_run_;
+    int          fd_;
+    std::mutex   mtx_;
+    std::thread  thrd_;
+    ring_vec_t   rings_;
+    size_t       nblk_;
+    size_t       bpos_;
+    struct iovec iov_[PC_LOG_OUT_BLOCKS];
+    char         obuf_[PC_LOG_OUT_BLOCKS][PC_LOG_OUT_BLOCK_SIZE];
+  };
+
+  // releases calling thread's ring for reuse on thread exit
+  class log_ring_ref
+  {
+  public:
+    log_ring_ref() : ptr_( nullptr ) {}
+    ~log_ring_ref() { if ( ptr_ ) ptr_->release(); }
+    log_ring *ptr_;
   };
 
 }
 
 using namespace pc;
 
+///////////////////////////////////////////////////////////////////////////
+// log_ring
+
+log_ring::log_ring()
+: head_( 0UL ),
+  tail_( 0UL ),
+  drop_( 0UL ),
+  is_used_( false )
+{
+}
+
+bool log_ring::acquire()
+{
+  bool exp = false;
+  return is_used_.compare_exchange_strong( exp, true );
+}
+
+void log_ring::release()
+{
+  is_used_.store( false );
+}
+
+///////////////////////////////////////////////////////////////////////////
+// log_impl
+
 static void run_log( log_impl *iptr )
 {
   iptr->run();
@@ -45,25 +116,35 @@ static void run_log( log_impl *iptr )
 
 log_impl::log_impl()
 : is_run_( true ),
-  is_wtr_( false ),
-  strm_( &std::cerr )
+  fd_( STDERR_FILENO ),
+  nblk_( 0 ),
+  bpos_( 0 )
 {
 }
 
 log_impl::~log_impl()
 {
   stop();
+  for( log_ring *ptr: rings_ ) {
+    delete ptr;
+  }
+  rings_.clear();
+  if ( fd_ != STDERR_FILENO ) {
+    ::close( fd_ );
+  }
 }
 
 bool log_impl::set_log_file( const std::string& filen )
 {
-  logf_.open( filen.c_str() );
-  if ( logf_.good() ) {
-    strm_ = &logf_;
-    return true;
-  } else {
+  int fd = ::open( filen.c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0644 );
+  if ( fd < 0 ) {
     return false;
   }
+  if ( fd_ != STDERR_FILENO ) {
+    ::close( fd_ );
+  }
+  fd_ = fd;
+  return true;
 }
 
 void log_impl::start()
@@ -79,33 +160,21 @@ void log_impl::stop()
   if ( thrd_.joinable() ) {
     thrd_.join();
   }
-  for( net_buf *ptr: reuse_ ) {
-    while( ptr ) {
-      net_buf *nxt = ptr->next_;
-      delete ptr;
-      ptr = nxt;
-    }
-  }
-  reuse_.clear();
 }
 
-void log_impl::add( net_wtr& wtr )
+log_ring *log_impl::get_ring()
 {
-  buf_vec_t reuse;
-  net_buf *hd, *tl;
-  wtr.detach( hd, tl );
-  mtx_.lock();
-  logv_.push_back( hd );
-  reuse.swap( reuse_ );
-  is_wtr_ = true;
-  mtx_.unlock();
-  for( net_buf *ptr: reuse ) {
-    while( ptr ) {
-      net_buf *nxt = ptr->next_;
-      ptr->dealloc();
-      ptr = nxt;
+  // reuse ring of an exited thread or allocate a new one
+  std::lock_guard<std::mutex> lck( mtx_ );
+  for( log_ring *ptr: rings_ ) {
+    if ( ptr->acquire() ) {
+      return ptr;
     }
   }
+  log_ring *ptr = new log_ring;
+  ptr->acquire();
+  rings_.push_back( ptr );
+  return ptr;
 }
 
 void log_impl::run()
@@ -113,30 +182,14 @@ void log_impl::run()
   struct timespec ts[1];
   ts->tv_sec  = 0;
   ts->tv_nsec = 1000000;
-  buf_vec_t logv;
+  ring_vec_t rings;
   for(;;) {
-    if ( is_wtr_ ) {
-      // get buffers to log
-      mtx_.lock();
-      is_wtr_ = false;
-      logv_.swap( logv );
-      mtx_.unlock();
-
-      // write the buffers to stderr
-      for( net_buf *ptr: logv ) {
-        while( ptr ) {
-          net_buf *nxt = ptr->next_;
-          strm_->write( ptr->buf_, ptr->size_ );
-          ptr = nxt;
-        }
-        (*strm_) << std::endl;
-      }
-
-      // send buffers back
-      mtx_.lock();
-      std::copy( logv.begin(), logv.end(), std::back_inserter( reuse_ ) );
-      mtx_.unlock();
-      logv.clear();
+    // refresh set of rings and drain them
+    mtx_.lock();
+    rings = rings_;
+    mtx_.unlock();
+    if ( drain( rings ) ) {
+      flush();
     } else if ( !is_run_ ) {
       break;
     } else {
@@ -146,8 +199,234 @@ void log_impl::run()
   }
 }
 
+bool log_impl::drain( ring_vec_t& rings )
+{
+  // merge records across rings in timestamp order
+  char rec[PC_LOG_REC_SIZE];
+  bool has_rec = false;
+  for(;;) {
+    log_ring *rptr = nullptr;
+    log_hdr   hdr, rhdr = log_hdr();
+    for( log_ring *ptr: rings ) {
+      uint64_t head = ptr->get_head();
+      if ( head != ptr->get_pub_tail() ) {
+        ptr->read( head, &hdr, log_hdr_len );
+        if ( !rptr || hdr.ts_ < rhdr.ts_ ) {
+          rptr = ptr;
+          rhdr = hdr;
+        }
+      }
+    }
+    if ( !rptr ) {
+      break;
+    }
+    uint64_t head = rptr->get_head();
+    rptr->read( head, rec, rhdr.len_ );
+    rptr->consume( head + rhdr.len_ );
+    format( rec, rhdr.len_ );
+    has_rec = true;
+  }
+
+  // report lines dropped due to full rings
+  uint64_t num_drop = 0;
+  for( log_ring *ptr: rings ) {
+    num_drop += ptr->swap_drop();
+  }
+  if ( num_drop ) {
+    format_drop( num_drop );
+    has_rec = true;
+  }
+  return has_rec;
+}
+
+static const char spaces[] =
+"                                                                         ";
+
+static int log_pid = getpid();
+
+void log_impl::add_header(
+    int64_t ts, uint32_t lvl, const char *topic, size_t len )
+{
+  char tbuf[32];
+  nsecs_to_utc6( ts, tbuf );
+  add( '[' );
+  add( tbuf, 27 );
+  add( ' ' );
+  add_i64( log_pid );
+  add( ' ' );
+  switch(lvl) {
+    case PC_LOG_DBG_LVL: add( "DBG", 3 );break;
+    case PC_LOG_INF_LVL: add( "INF", 3 );break;
+    case PC_LOG_WRN_LVL: add( "WRN", 3 );break;
+    case PC_LOG_ERR_LVL: add( "ERR", 3 );break;
+  }
+  add( ' ' );
+  add( topic, len );
+  if ( len < PC_LOG_TOPIC_LEN ) {
+    add( spaces, PC_LOG_TOPIC_LEN-len );
+  }
+  add( ']' );
+  add( ' ' );
+}
+
+void log_impl::format( const char *rec, size_t len )
+{
+  log_hdr hdr;
+  __builtin_memcpy( &hdr, rec, log_hdr_len );
+  const char *ptr = &rec[log_hdr_len];
+  const char *end = &rec[len];
+  add_header( hdr.ts_, hdr.lvl_, ptr, hdr.tlen_ );
+  ptr += hdr.tlen_;
+  for( bool is_first = true; ptr < end; is_first = false ) {
+    uint8_t typ  = (uint8_t)ptr[0];
+    uint8_t klen = (uint8_t)ptr[1];
+    ptr += 2;
+    if ( !is_first ) {
+      add( ',' );
+    }
+    add( ptr, klen );
+    add( '=' );
+    ptr += klen;
+    switch( typ ) {
+      case e_log_str: {
+        uint16_t vlen;
+        __builtin_memcpy( &vlen, ptr, sizeof( vlen ) );
+        ptr += sizeof( vlen );
+        add( ptr, vlen );
+        ptr += vlen;
+        break;
+      }
+      case e_log_pkey: {
+        char buf[64];
+        int blen = enc_base58_fixed<pub_key::len>(
+            (const uint8_t*)ptr, (uint8_t*)buf, sizeof(buf) );
+        add( buf, blen );
+        ptr += pub_key::len;
+        break;
+      }
+      case e_log_i64: {
+        int64_t val;
+        __builtin_memcpy( &val, ptr, sizeof( val ) );
+        add_i64( val );
+        ptr += sizeof( val );
+        break;
+      }
+      case e_log_u64: {
+        uint64_t val;
+        __builtin_memcpy( &val, ptr, sizeof( val ) );
+        add_u64( val );
+        ptr += sizeof( val );
+        break;
+      }
+      case e_log_f64: {
+        double val;
+        __builtin_memcpy( &val, ptr, sizeof( val ) );
+        add_f64( val );
+        ptr += sizeof( val );
+        break;
+      }
+    }
+  }
+  add( '\n' );
+}
+
+void log_impl::format_drop( uint64_t num )
+{
+  static const char topic[] = "log_dropped";
+  add_header( get_now(), PC_LOG_WRN_LVL, topic, sizeof( topic ) - 1 );
+  add( "num_lines=", 10 );
+  add_u64( num );
+  add( '\n' );
+}
+
+void log_impl::add( const char *ptr, size_t len )
+{
+  while( len ) {
+    if ( bpos_ == PC_LOG_OUT_BLOCK_SIZE ) {
+      if ( ++nblk_ == PC_LOG_OUT_BLOCKS ) {
+        flush();
+      } else {
+        bpos_ = 0;
+      }
+    }
+    size_t num = std::min( len, PC_LOG_OUT_BLOCK_SIZE - bpos_ );
+    __builtin_memcpy( &obuf_[nblk_][bpos_], ptr, num );
+    bpos_ += num;
+    ptr   += num;
+    len   -= num;
+  }
+}
+
+void log_impl::add( char val )
+{
+  add( &val, 1 );
+}
+
+void log_impl::add_u64( uint64_t val )
+{
+  char buf[24], *end = &buf[sizeof(buf)], *ptr = end;
+  do {
+    *--ptr = '0' + (val%10UL);
+    val /= 10UL;
+  } while( val );
+  add( ptr, end - ptr );
+}
+
+void log_impl::add_i64( int64_t val )
+{
+  if ( val < 0 ) {
+    add( '-' );
+    add_u64( -(uint64_t)val );
+  } else {
+    add_u64( val );
+  }
+}
+
+void log_impl::add_f64( double val )
+{
+  char buf[512];
+  int len = snprintf( buf, sizeof( buf ), "%f", val );
+  add( buf, std::min( (size_t)len, sizeof( buf ) - 1 ) );
+}
+
+void log_impl::flush()
+{
+  // write all filled output blocks with a single writev
+  size_t niov = 0;
+  for( size_t i=0; i <= nblk_ && i != PC_LOG_OUT_BLOCKS; ++i ) {
+    size_t len = i == nblk_ ? bpos_ : PC_LOG_OUT_BLOCK_SIZE;
+    if ( len ) {
+      iov_[niov].iov_base = obuf_[i];
+      iov_[niov].iov_len  = len;
+      ++niov;
+    }
+  }
+  struct iovec *iptr = iov_;
+  while( niov ) {
+    ssize_t num = ::writev( fd_, iptr, niov );
+    if ( num < 0 ) {
+      break;
+    }
+    while( niov && (size_t)num >= iptr->iov_len ) {
+      num -= iptr->iov_len;
+      ++iptr;
+      --niov;
+    }
+    if ( niov ) {
+      iptr->iov_base = (char*)iptr->iov_base + num;
+      iptr->iov_len -= num;
+    }
+  }
+  nblk_ = 0;
+  bpos_ = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// log
+
 int log::level_ = 0;
 static log_impl impl_;
+static thread_local log_ring_ref ring_ref_;
 
 void log::set_level( int t )
 {
@@ -169,123 +448,159 @@ log_line log::add( str topic, int level )
   return log_line( topic, level );
 }
 
-static const char spaces[] =
-"                                                                         ";
+log_line log::add( str topic, int level, log_limit& lim )
+{
+  log_line line( topic, level );
+  uint64_t nsup = lim.swap_suppressed();
+  if ( nsup ) {
+    line.add( "num_suppressed", nsup );
+  }
+  return line;
+}
 
-static int log_pid = getpid();
+///////////////////////////////////////////////////////////////////////////
+// log_limit
 
-void log_wtr::add_i64( int64_t val )
+log_limit::log_limit( uint64_t per_sec, uint64_t burst )
+: nsup_( 0 )
 {
-  char *buf = reserve( 32 );
-  sprintf( buf, "%ld", val );
-  advance( __builtin_strlen( buf ) );
+  set_rate( per_sec, burst );
 }
 
-void log_wtr::add_u64( uint64_t val )
+void log_limit::set_rate( uint64_t per_sec, uint64_t burst )
 {
-  char *buf = reserve( 32 );
-  sprintf( buf, "%lu", val );
-  advance( __builtin_strlen( buf ) );
+  int_ = PC_NSECS_IN_SEC / std::max( per_sec, 1UL );
+  cap_ = int_ * std::max( burst, 1UL );
+  tok_ = cap_;
+  ts_  = get_now();
 }
 
-void log_wtr::add_f64( double val )
+uint64_t log_limit::swap_suppressed()
 {
-  char *buf = reserve( 32 );
-  sprintf( buf, "%f", val );
-  advance( __builtin_strlen( buf ) );
+  uint64_t nsup = nsup_;
+  nsup_ = 0;
+  return nsup;
 }
 
+///////////////////////////////////////////////////////////////////////////
+// log_line
+
 log_line::log_line( str topic, int lvl )
-: is_first_( true )
 {
-  char tbuf[32];
-  nsecs_to_utc6( get_now(), tbuf );
-  wtr_.add( '[' );
-  wtr_.add( str( tbuf, 27 ) );
-  wtr_.add( ' ' );
-  wtr_.add_i64( log_pid );
-  wtr_.add( ' ' );
-  switch(lvl) {
-    case PC_LOG_DBG_LVL: wtr_.add( "DBG" );break;
-    case PC_LOG_INF_LVL: wtr_.add( "INF" );break;
-    case PC_LOG_WRN_LVL: wtr_.add( "WRN" );break;
-    case PC_LOG_ERR_LVL: wtr_.add( "ERR" );break;
+  ring_ = ring_ref_.ptr_;
+  if ( !ring_ ) {
+    ring_ = ring_ref_.ptr_ = impl_.get_ring();
   }
-  wtr_.add( ' ' );
-  const size_t topic_len = 40;
-  size_t len = std::min( topic.len_, topic_len );
-  wtr_.add( str( topic.str_, len ) );
-  if ( len < topic_len ) {
-    wtr_.add( str( spaces, topic_len-len ) );
+  tail_ = ring_->get_tail();
+  if ( !ring_->has_space( tail_ ) ) {
+    ring_->inc_drop();
+    ring_ = nullptr;
+    return;
   }
-  wtr_.add( ']' );
-  wtr_.add( ' ' );
+  log_hdr hdr;
+  hdr.len_  = 0;
+  hdr.lvl_  = lvl;
+  hdr.ts_   = get_now();
+  hdr.tlen_ = std::min( topic.len_, (size_t)PC_LOG_TOPIC_LEN );
+  ring_->write( tail_, &hdr, log_hdr_len );
+  ring_->write( tail_ + log_hdr_len, topic.str_, hdr.tlen_ );
+  pos_ = tail_ + log_hdr_len + hdr.tlen_;
 }
 
-void log_line::add_key( str key )
+bool log_line::add_key( str key, uint8_t typ, size_t vlen )
 {
-  if ( !is_first_ ) {
-    wtr_.add( ',' );
-  } else {
-    is_first_ = false;
+  if ( !ring_ ) {
+    return false;
+  }
+  uint8_t klen = std::min( key.len_, (size_t)255 );
+  if ( pos_ + 2 + klen + vlen > tail_ + PC_LOG_REC_SIZE ) {
+    return false;
   }
-  wtr_.add( key );
-  wtr_.add( '=' );
+  uint8_t pfx[2] = { typ, klen };
+  ring_->write( pos_, pfx, 2 );
+  ring_->write( pos_ + 2, key.str_, klen );
+  pos_ += 2 + klen;
+  return true;
+}
+
+void log_line::add_val( const void *ptr, size_t len )
+{
+  ring_->write( pos_, ptr, len );
+  pos_ += len;
 }
 
 log_line& log_line::add( str key, str val )
 {
-  add_key( key );
-  wtr_.add( val );
+  // truncate string value to remaining record space
+  if ( !ring_ ) {
+    return *this;
+  }
+  size_t used = pos_ - tail_ + 2 + std::min( key.len_, (size_t)255 ) + 2;
+  uint16_t vlen = 0;
+  if ( used < PC_LOG_REC_SIZE ) {
+    vlen = std::min( val.len_, PC_LOG_REC_SIZE - used );
+  }
+  if ( add_key( key, e_log_str, sizeof( vlen ) + vlen ) ) {
+    add_val( &vlen, sizeof( vlen ) );
+    add_val( val.str_, vlen );
+  }
   return *this;
 }
 
 log_line& log_line::add( str key, int32_t val )
 {
-  add_key( key );
-  wtr_.add_i64( val );
-  return *this;
+  return add( key, (int64_t)val );
 }
 
 log_line& log_line::add( str key, int64_t val )
 {
-  add_key( key );
-  wtr_.add_i64( val );
+  if ( add_key( key, e_log_i64, sizeof( val ) ) ) {
+    add_val( &val, sizeof( val ) );
+  }
   return *this;
 }
 
 log_line& log_line::add( str key, uint64_t val )
 {
-  add_key( key );
-  wtr_.add_u64( val );
+  if ( add_key( key, e_log_u64, sizeof( val ) ) ) {
+    add_val( &val, sizeof( val ) );
+  }
   return *this;
 }
 
 log_line& log_line::add( str key, uint32_t val )
 {
-  add_key( key );
-  wtr_.add_u64( val );
-  return *this;
+  return add( key, (uint64_t)val );
 }
 
 log_line& log_line::add( str key, double val )
 {
-  add_key( key );
-  wtr_.add_f64( val );
+  if ( add_key( key, e_log_f64, sizeof( val ) ) ) {
+    add_val( &val, sizeof( val ) );
+  }
   return *this;
 }
 
 log_line& log_line::add( str key, const pub_key& pk )
 {
-  add_key( key );
-  std::string res;
-  pk.enc_base58( res );
-  wtr_.add( res );
+  if ( add_key( key, e_log_pkey, pub_key::len ) ) {
+    add_val( pk.data(), pub_key::len );
+  }
   return *this;
 }
 
+log_line& log_line::add( str key, const pub_key_b58& pk )
+{
+  return add( key, pk.get_text() );
+}
+
 void log_line::end()
 {
-  impl_.add( wtr_ );
-  wtr_.reset();
+  // fill in record length and publish to log thread
+  if ( ring_ ) {
+    uint32_t len = pos_ - tail_;
+    ring_->write( tail_, &len, sizeof( len ) );
+    ring_->publish( pos_ );
+    ring_ = nullptr;
+  }
 }
@@ -1,36 +1,115 @@
 #pragma once
 
 #include <pc/net_socket.hpp>
+#include <atomic>
 
 #define PC_LOG_DBG_LVL (1U<<3)
 #define PC_LOG_INF_LVL (1U<<2)
 #define PC_LOG_WRN_LVL (1U<<1)
 #define PC_LOG_ERR_LVL (1U<<0)
 
+// most verbose log level compiled in; lines above it are compiled out
+#ifndef PC_LOG_BUILD_LVL
+#define PC_LOG_BUILD_LVL PC_LOG_DBG_LVL
+#endif
+
 #define PC_LOG_TXT(X,LVL) \
-if (pc::log::has_level(LVL)) pc::log::add(X,LVL)
+if (pc::log_build<LVL>::enabled && pc::log::has_level(LVL)) \
+  pc::log::add(X,LVL)
 #define PC_LOG_DBG(X) PC_LOG_TXT(X,PC_LOG_DBG_LVL)
 #define PC_LOG_INF(X) PC_LOG_TXT(X,PC_LOG_INF_LVL)
 #define PC_LOG_WRN(X) PC_LOG_TXT(X,PC_LOG_WRN_LVL)
 #define PC_LOG_ERR(X) PC_LOG_TXT(X,PC_LOG_ERR_LVL)
 
+// rate-limited log lines throttled by a log_limit token bucket
+#define PC_LOG_TXT_LIMIT(X,LVL,LIM) \
+if (pc::log_build<LVL>::enabled && pc::log::has_level(LVL) && \
+    (LIM).allow()) pc::log::add(X,LVL,LIM)
+#define PC_LOG_WRN_LIMIT(X,LIM) PC_LOG_TXT_LIMIT(X,PC_LOG_WRN_LVL,LIM)
+#define PC_LOG_ERR_LIMIT(X,LIM) PC_LOG_TXT_LIMIT(X,PC_LOG_ERR_LVL,LIM)
+
+// per-thread log ring size (power of 2) and max size of one record
+#define PC_LOG_RING_SIZE (1UL<<18)
+#define PC_LOG_REC_SIZE  4096UL
+
 namespace pc
 {
 
-  class log_wtr : public net_wtr
+  // compile-time log level gating
+  template<unsigned LVL>
+  struct log_build
+  {
+    static constexpr bool enabled = LVL <= PC_LOG_BUILD_LVL;
+  };
+
+  // token bucket limiting the rate of a log topic
+  // not thread-safe; use one per topic per thread
+  class log_limit
   {
   public:
-    void add_i64( int64_t );
-    void add_u64( uint64_t );
-    void add_f64( double );
+    log_limit( uint64_t per_sec, uint64_t burst );
+
+    // change rate and burst size
+    void set_rate( uint64_t per_sec, uint64_t burst );
+
+    // consume token if available
+    bool allow();
+
+    // number of lines suppressed since last call
+    uint64_t swap_suppressed();
+
+  private:
+    int64_t  int_;   // nanoseconds per token
+    int64_t  cap_;   // bucket capacity in nanoseconds
+    int64_t  tok_;   // current bucket level in nanoseconds
+    int64_t  ts_;    // last refill time
+    uint64_t nsup_;  // number of suppressed lines
+  };
+
+  // single-producer, single-consumer ring of binary log records
+  // written by one logging thread and drained by the log thread
+  class log_ring
+  {
+  public:
+    log_ring();
+
+    // producer side
+    uint64_t get_tail() const;
+    bool has_space( uint64_t tail ) const;
+    void write( uint64_t pos, const void *, size_t len );
+    void publish( uint64_t tail );
+    void inc_drop();
+
+    // consumer side
+    uint64_t get_head() const;
+    uint64_t get_pub_tail() const;
+    void read( uint64_t pos, void *, size_t len ) const;
+    void consume( uint64_t head );
+    uint64_t swap_drop();
+
+    // thread ownership of ring
+    bool acquire();
+    void release();
+
+  private:
+    std::atomic<uint64_t> head_;
+    char                  pad1_[56];
+    std::atomic<uint64_t> tail_;
+    char                  pad2_[56];
+    std::atomic<uint64_t> drop_;
+    std::atomic<bool>     is_used_;
+    char                  buf_[PC_LOG_RING_SIZE];
   };
 
   // log line
+  // arguments are copied raw into the calling thread's ring and
+  // formatted to text by the log thread
   class log_line
   {
   public:
     log_line& add( str key, str val );
     log_line& add( str key, const pub_key& val );
+    log_line& add( str key, const pub_key_b58& val );
     log_line& add( str key, int32_t );
     log_line& add( str key, int64_t );
     log_line& add( str key, uint64_t );
@@ -40,9 +119,11 @@ namespace pc
     friend class log;
   private:
     log_line( str, int lvl );
-    void add_key( str );
-    bool    is_first_;
-    log_wtr wtr_;
+    bool add_key( str, uint8_t typ, size_t vlen );
+    void add_val( const void *, size_t );
+    log_ring *ring_;
+    uint64_t  tail_;
+    uint64_t  pos_;
   };
 
   // log reporting
@@ -54,6 +135,7 @@ namespace pc
     static void set_level( int level );
     static bool has_level( int level );
     static log_line add( str topic, int level );
+    static log_line add( str topic, int level, log_limit& );
   private:
     static int level_;
   };
@@ -63,4 +145,78 @@ namespace pc
     return level&level_;
   }
 
+  inline bool log_limit::allow()
+  {
+    int64_t now = get_now();
+    tok_ = std::min( cap_, tok_ + now - ts_ );
+    ts_  = now;
+    if ( tok_ >= int_ ) {
+      tok_ -= int_;
+      return true;
+    }
+    ++nsup_;
+    return false;
+  }
+
+  inline uint64_t log_ring::get_tail() const
+  {
+    return tail_.load( std::memory_order_relaxed );
+  }
+
+  inline bool log_ring::has_space( uint64_t tail ) const
+  {
+    uint64_t head = head_.load( std::memory_order_acquire );
+    return tail + PC_LOG_REC_SIZE - head <= PC_LOG_RING_SIZE;
+  }
+
+  inline void log_ring::write( uint64_t pos, const void *ptr, size_t len )
+  {
+    size_t off = pos & (PC_LOG_RING_SIZE-1);
+    size_t num = std::min( len, PC_LOG_RING_SIZE - off );
+    __builtin_memcpy( &buf_[off], ptr, num );
+    if ( num < len ) {
+      __builtin_memcpy( buf_, (const char*)ptr + num, len - num );
+    }
+  }
+
+  inline void log_ring::publish( uint64_t tail )
+  {
+    tail_.store( tail, std::memory_order_release );
+  }
+
+  inline void log_ring::inc_drop()
+  {
+    drop_.fetch_add( 1, std::memory_order_relaxed );
+  }
+
+  inline uint64_t log_ring::get_head() const
+  {
+    return head_.load( std::memory_order_relaxed );
+  }
+
+  inline uint64_t log_ring::get_pub_tail() const
+  {
+    return tail_.load( std::memory_order_acquire );
+  }
+
+  inline void log_ring::read( uint64_t pos, void *ptr, size_t len ) const
+  {
+    size_t off = pos & (PC_LOG_RING_SIZE-1);
+    size_t num = std::min( len, PC_LOG_RING_SIZE - off );
+    __builtin_memcpy( ptr, &buf_[off], num );
+    if ( num < len ) {
+      __builtin_memcpy( (char*)ptr + num, buf_, len - num );
+    }
+  }
+
+  inline void log_ring::consume( uint64_t head )
+  {
+    head_.store( head, std::memory_order_release );
+  }
+
+  inline uint64_t log_ring::swap_drop()
+  {
+    return drop_.exchange( 0, std::memory_order_relaxed );
+  }
+
 }
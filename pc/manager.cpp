@@ -9,6 +9,12 @@ using namespace pc;
 #define PC_BLOCKHASH_TIMEOUT  3
 #define PC_PUB_INTERVAL       (227L*PC_NSECS_IN_MSEC)
 #define PC_RPC_HOST           "localhost"
+#define PC_RESYNC_BATCH       256
+#define PC_SNAPSHOT_INTERVAL  (60L*PC_NSECS_IN_SEC)
+#define PC_MCAST_SNAP_INTERVAL (100L*PC_NSECS_IN_MSEC)
+#define PC_MCAST_SNAP_BATCH   64
+#define PC_INVALID_LOG_RATE   4
+#define PC_INVALID_LOG_BURST  16
 
 ///////////////////////////////////////////////////////////////////////////
 // manager_sub
@@ -45,7 +51,8 @@ void manager_sub::on_add_symbol( manager *, price * )
 // manager
 
 manager::manager()
-: thost_( PC_RPC_HOST ),
+: nhttp_( 1 ),
+  thost_( PC_RPC_HOST ),
   rhost_( PC_RPC_HOST ),
   sub_( nullptr ),
   status_( 0 ),
@@ -61,8 +68,27 @@ manager::manager()
   wait_conn_( false ),
   do_cap_( false ),
   do_tx_( true ),
+  do_coal_( false ),
   is_pub_( false ),
-  cmt_( commitment::e_confirmed )
+  cmt_( commitment::e_confirmed ),
+  do_sync_( false ),
+  is_sync_( false ),
+  ridx_( 0 ),
+  rnum_( 0 ),
+  rslot_( 0UL ),
+  rts_( 0L ),
+  do_snap_( false ),
+  is_warm_( false ),
+  sts_( 0L ),
+  do_shm_( false ),
+  do_ing_( false ),
+  ing_inv_( 0UL ),
+  ilim_( PC_INVALID_LOG_RATE, PC_INVALID_LOG_BURST ),
+  do_mcast_( false ),
+  midx_( 0 ),
+  mts_( 0L ),
+  plist_ver_( 0UL ),
+  plist_ok_( false )
 {
   tconn_.set_sub( this );
   breq_->set_sub( this );
@@ -75,6 +101,15 @@ manager::manager()
 manager::~manager()
 {
   teardown();
+  ureq_->reset();
+  for( tcp_connect *hptr: hpool_ ) {
+    delete hptr;
+  }
+  hpool_.clear();
+  for( rpc_feed *fptr: fvec_ ) {
+    delete fptr;
+  }
+  fvec_.clear();
   for( get_mapping *mptr: mvec_ ) {
     delete mptr;
   }
@@ -83,6 +118,7 @@ manager::~manager()
     delete ptr;
   }
   svec_.clear();
+  pvec_.clear();
 }
 
 bool manager::tx_parser::parse( const char *, size_t len, size_t& res )
@@ -139,6 +175,59 @@ bool manager::get_do_tx() const
   return do_tx_;
 }
 
+void manager::add_rpc_feed( const std::string& host )
+{
+  rpc_feed *fptr = new rpc_feed;
+  fptr->set_host( host );
+  fptr->set_sub( this );
+  fvec_.push_back( fptr );
+}
+
+const feed_stats& manager::get_rpc_stats() const
+{
+  return rstat_;
+}
+
+unsigned manager::get_num_rpc_feed() const
+{
+  return fvec_.size();
+}
+
+rpc_feed *manager::get_rpc_feed( unsigned i ) const
+{
+  return fvec_[i];
+}
+
+void manager::set_num_http_conn( unsigned num )
+{
+  nhttp_ = num ? num : 1;
+}
+
+unsigned manager::get_num_http_conn() const
+{
+  return nhttp_;
+}
+
+void manager::set_do_coalesce( bool do_coal )
+{
+  do_coal_ = do_coal;
+}
+
+bool manager::get_do_coalesce() const
+{
+  return do_coal_;
+}
+
+void manager::set_do_resync( bool do_sync )
+{
+  do_sync_ = do_sync;
+}
+
+bool manager::get_do_resync() const
+{
+  return do_sync_;
+}
+
 void manager::set_capture_file( const std::string& cap_file )
 {
   cap_.set_file( cap_file );
@@ -159,6 +248,55 @@ int64_t manager::get_publish_interval() const
   return pub_int_ / PC_NSECS_IN_MSEC;
 }
 
+void manager::set_snapshot_file( const std::string& file )
+{
+  snap_.set_file( file );
+  do_snap_ = !file.empty();
+}
+
+std::string manager::get_snapshot_file() const
+{
+  return snap_.get_file();
+}
+
+void manager::set_shm_file( const std::string& file )
+{
+  shm_.set_file( file );
+  do_shm_ = !file.empty();
+}
+
+std::string manager::get_shm_file() const
+{
+  return shm_.get_file();
+}
+
+void manager::set_shm_ingress_file( const std::string& file )
+{
+  ing_.set_file( file );
+  do_ing_ = !file.empty();
+}
+
+std::string manager::get_shm_ingress_file() const
+{
+  return ing_.get_file();
+}
+
+uint64_t manager::get_num_ingress_invalid() const
+{
+  return ing_inv_;
+}
+
+void manager::set_mcast_addr( const std::string& addr )
+{
+  mcst_.set_addr( addr );
+  do_mcast_ = !addr.empty();
+}
+
+std::string manager::get_mcast_addr() const
+{
+  return mcst_.get_addr();
+}
+
 void manager::set_do_capture( bool do_cap )
 {
   do_cap_ = do_cap;
@@ -233,8 +371,14 @@ void manager::teardown()
 {
   PC_LOG_INF( "pythd_teardown" ).end();
 
-  // shutdown listener
+  // shutdown listener and shared-memory ingress
   lsvr_.close();
+  ing_.close();
+  if ( ing_inv_ ) {
+    PC_LOG_INF( "shm_ingress_stats" )
+      .add( "num_invalid", ing_inv_ )
+      .end();
+  }
 
   // destroy any open users
   while( !olist_.empty() ) {
@@ -244,9 +388,34 @@ void manager::teardown()
   }
   teardown_users();
 
+  // save accounts for next warm start
+  if ( do_snap_ && has_status( PC_PYTH_HAS_MAPPING ) ) {
+    save_snapshot();
+  }
+
   // destroy rpc connections
   hconn_.close();
+  for( tcp_connect *hptr: hpool_ ) {
+    hptr->close();
+  }
   wconn_.close();
+  for( rpc_feed *fptr: fvec_ ) {
+    PC_LOG_INF( "rpc_feed_stats" )
+      .add( "host", fptr->get_host() )
+      .add( "num_upd", fptr->get_num_upd() )
+      .add( "win_rate", fptr->get_win_rate() )
+      .add( "lag_us", fptr->get_lag() / 1000L )
+      .end();
+    fptr->close();
+  }
+  if ( !fvec_.empty() ) {
+    PC_LOG_INF( "rpc_feed_stats" )
+      .add( "host", rhost_ )
+      .add( "num_upd", rstat_.get_num_upd() )
+      .add( "win_rate", rstat_.get_win_rate() )
+      .add( "lag_us", rstat_.get_lag() / 1000L )
+      .end();
+  }
 }
 
 bool manager::init()
@@ -275,11 +444,34 @@ bool manager::init()
     return set_err_msg( cap_.get_err_msg() );
   }
 
+  // initialize shared-memory price feed
+  if ( do_shm_ && !shm_.init() ) {
+    return set_err_msg( shm_.get_err_msg() );
+  }
+
+  // initialize multicast price feed
+  if ( do_mcast_ && !mcst_.init() ) {
+    return set_err_msg( mcst_.get_err_msg() );
+  }
+
+  // rebuild accounts from warm-start snapshot
+  if ( do_snap_ ) {
+    load_snapshot();
+  }
+
   // initialize net_loop
   if ( !nl_.init() ) {
     return set_err_msg( nl_.get_err_msg() );
   }
 
+  // initialize shared-memory price update ingress
+  if ( do_ing_ ) {
+    ing_.set_net_loop( &nl_ );
+    if ( !ing_.init() ) {
+      return set_err_msg( ing_.get_err_msg() );
+    }
+  }
+
   // decompose rpc_host into host:port
   int rport =0, wport = 0;
   std::string rhost = get_host_port( rhost_, rport, wport );
@@ -291,6 +483,14 @@ bool manager::init()
   hconn_.set_host( rhost );
   hconn_.set_net_loop( &nl_ );
   clnt_.set_http_conn( &hconn_ );
+  while( hpool_.size() + 1 < nhttp_ ) {
+    tcp_connect *hptr = new tcp_connect;
+    hptr->set_port( rport );
+    hptr->set_host( rhost );
+    hptr->set_net_loop( &nl_ );
+    clnt_.add_http_conn( hptr );
+    hpool_.push_back( hptr );
+  }
   wconn_.set_port( wport );
   wconn_.set_host( rhost );
   wconn_.set_net_loop( &nl_ );
@@ -298,9 +498,21 @@ bool manager::init()
   if ( !hconn_.init() ) {
     return set_err_msg( hconn_.get_err_msg() );
   }
+  for( tcp_connect *hptr: hpool_ ) {
+    if ( !hptr->init() ) {
+      return set_err_msg( hptr->get_err_msg() );
+    }
+  }
   if ( !wconn_.init() ) {
     return set_err_msg( wconn_.get_err_msg() );
   }
+  for( rpc_feed *fptr: fvec_ ) {
+    fptr->set_program( get_program_pub_key() );
+    fptr->set_commitment( get_commitment() );
+    if ( !fptr->init( &nl_ ) ) {
+      return set_err_msg( fptr->get_err_msg() );
+    }
+  }
   // connect to pyth_tx server
   if ( do_tx_ ) {
     int tport1 = 0, tport2 = 0;
@@ -397,12 +609,23 @@ void manager::poll( bool do_wait )
 {
   // poll for any socket events
   if ( do_wait ) {
-    nl_.poll( 1 );
+    // do not block while shared-memory updates are waiting
+    int timeout = !do_ing_ || ing_.set_wait() ? 1 : 0;
+    nl_.poll( timeout );
+    if ( do_ing_ ) {
+      ing_.reset_wait();
+    }
   } else {
     if ( has_status( PC_PYTH_RPC_CONNECTED ) ) {
       hconn_.poll();
+      for( tcp_connect *hptr: hpool_ ) {
+        hptr->poll();
+      }
       wconn_.poll();
     }
+    for( rpc_feed *fptr: fvec_ ) {
+      fptr->poll();
+    }
     if ( do_tx_ ) {
       tconn_.poll();
     }
@@ -416,6 +639,22 @@ void manager::poll( bool do_wait )
     }
   }
 
+  // publish price updates queued in shared memory
+  if ( do_ing_ ) {
+    poll_ingress();
+  }
+
+  // send multicast price updates batched during poll
+  if ( do_mcast_ ) {
+    poll_mcast();
+  }
+
+  // send conflated and binary api price notifications batched during poll
+  for( user *uptr = olist_.first(); uptr; uptr = uptr->get_next() ) {
+    uptr->flush_pending();
+    uptr->flush_bin();
+  }
+
   // submit pending requests
   for( request *rptr =plist_.first(); rptr; ) {
     request *nxt = rptr->get_next();
@@ -438,14 +677,34 @@ void manager::poll( bool do_wait )
     tconn_.reconnect();
   }
 
-  // submit new quotes while connected
-  if ( has_status( PC_PYTH_RPC_CONNECTED ) &&
-       !hconn_.get_is_err() &&
-       !wconn_.get_is_err() ) {
+  // save warm-start snapshot periodically once accounts are complete
+  if ( do_snap_ && has_status( PC_PYTH_HAS_MAPPING ) &&
+       curr_ts_ - sts_ > PC_SNAPSHOT_INTERVAL ) {
+    sts_ = curr_ts_;
+    save_snapshot();
+  }
+
+  // keep racing rpc feeds connected
+  for( rpc_feed *fptr: fvec_ ) {
+    fptr->check( curr_ts_ );
+  }
+
+  // submit new quotes while connected. a failed primary websocket is
+  // reconnected on its own while a racing feed is still live
+  bool is_conn = has_status( PC_PYTH_RPC_CONNECTED ) && !get_is_http_err();
+  if ( is_conn && ( wfo_.get_is_fail() || wconn_.get_is_err() ) ) {
+    is_conn = reconnect_ws();
+  }
+  if ( is_conn ) {
     poll_schedule();
   } else {
     reconnect_rpc();
   }
+
+  // send price updates packed during poll
+  if ( !do_coal_ ) {
+    submit_prices();
+  }
 }
 
 void manager::poll_schedule()
@@ -468,18 +727,27 @@ void manager::poll_schedule()
 void manager::reconnect_rpc()
 {
   // check if connection process has complete
+  bool is_wait = false;
   if ( hconn_.get_is_wait() ) {
     hconn_.check();
+    is_wait = is_wait || hconn_.get_is_wait();
+  }
+  for( tcp_connect *hptr: hpool_ ) {
+    if ( hptr->get_is_wait() ) {
+      hptr->check();
+      is_wait = is_wait || hptr->get_is_wait();
+    }
   }
   if ( wconn_.get_is_wait() ) {
     wconn_.check();
+    is_wait = is_wait || wconn_.get_is_wait();
   }
-  if ( hconn_.get_is_wait() || wconn_.get_is_wait() ) {
+  if ( is_wait ) {
     return;
   }
 
   // check for successful (re)connect
-  if ( !hconn_.get_is_err() && !wconn_.get_is_err() ) {
+  if ( !get_is_http_err() && !wconn_.get_is_err() ) {
     PC_LOG_INF( "rpc_connected" ).end();
     set_status( PC_PYTH_RPC_CONNECTED );
 
@@ -493,7 +761,12 @@ void manager::reconnect_rpc()
     slot_ = 0L;
     num_sub_ = 0;
     clnt_.reset();
-    for(;;) {
+
+    // pending requests stay queued while resyncing
+    bool is_sync = ( do_sync_ || is_warm_ ) &&
+      has_status( PC_PYTH_HAS_MAPPING );
+    is_warm_ = false;
+    while( !is_sync ) {
       request *rptr = plist_.first();
       if ( rptr ) {
         rptr->set_is_submit( false );
@@ -511,23 +784,33 @@ void manager::reconnect_rpc()
     preq_->set_program( get_program_pub_key() );
     clnt_.send( preq_ );
 
-    // gather latest info on mapping accounts
-    for( get_mapping *mptr: mvec_ ) {
-      mptr->reset();
-      submit( mptr );
-      add_map_sub();
-    }
-    // gather latest info on product and price accounts
-    for( product *ptr: svec_ ) {
-      ptr->reset();
-      submit( ptr );
-      add_map_sub();
-      for( unsigned i=0; i != ptr->get_num_price(); ++i ) {
-        price *qptr = ptr->get_price( i );
-        qptr->reset();
-        submit( qptr );
+    if ( is_sync ) {
+      // keep accounts live and refetch stale ones from the first slot
+      PC_LOG_INF( "start_resync" ).end();
+      is_sync_ = true;
+      ridx_ = 0;
+      rnum_ = 0;
+      rslot_ = 0UL;
+      rts_ = get_now();
+    } else {
+      // gather latest info on mapping accounts
+      for( get_mapping *mptr: mvec_ ) {
+        mptr->reset();
+        submit( mptr );
         add_map_sub();
       }
+      // gather latest info on product and price accounts
+      for( product *ptr: svec_ ) {
+        ptr->reset();
+        submit( ptr );
+        add_map_sub();
+        for( unsigned i=0; i != ptr->get_num_price(); ++i ) {
+          price *qptr = ptr->get_price( i );
+          qptr->reset();
+          submit( qptr );
+          add_map_sub();
+        }
+      }
     }
 
     // add mapping account if not done before
@@ -553,7 +836,11 @@ void manager::reconnect_rpc()
   }
 
   // wait for reconnect timeout
-  status_ = 0;
+  if ( do_sync_ || is_warm_ ) {
+    reset_status( PC_PYTH_RPC_CONNECTED | PC_PYTH_HAS_BLOCK_HASH );
+  } else {
+    status_ = 0;
+  }
   int64_t ts = get_now();
   if ( ctimeout_ > (ts-cts_) ) {
     return;
@@ -565,9 +852,71 @@ void manager::reconnect_rpc()
   ctimeout_ = std::min( ctimeout_, PC_RECONNECT_TIMEOUT );
   wait_conn_ = true;
   hconn_.init();
+  for( tcp_connect *hptr: hpool_ ) {
+    hptr->init();
+  }
   wconn_.init();
 }
 
+bool manager::get_is_feed_live() const
+{
+  for( rpc_feed *fptr: fvec_ ) {
+    if ( fptr->get_is_live() ) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool manager::reconnect_ws()
+{
+  bool is_live = get_is_feed_live();
+  if ( is_live && !wfo_.get_is_fail() ) {
+    PC_LOG_ERR( "rpc_websocket_failover" )
+      .add( "error", wconn_.get_err_msg() )
+      .add( "host", rhost_ )
+      .add( "port", wconn_.get_port() )
+      .end();
+  }
+  if ( is_live && wconn_.get_is_wait() ) {
+    wconn_.check();
+  }
+  switch( wfo_.check( is_live, wconn_.get_is_wait(),
+                      wconn_.get_is_err(), curr_ts_ ) ) {
+    case ws_failover::e_reconnect_all: {
+      return false;
+    }
+    case ws_failover::e_connect: {
+      wconn_.init();
+      break;
+    }
+    case ws_failover::e_resubscribe: {
+      // resubscribe without re-bootstrapping accounts
+      PC_LOG_INF( "rpc_websocket_reconnected" ).end();
+      clnt_.remove_notify( sreq_ );
+      clnt_.remove_notify( preq_ );
+      clnt_.send( sreq_ );
+      clnt_.send( preq_ );
+      break;
+    }
+    default: break;
+  }
+  return true;
+}
+
+bool manager::get_is_http_err() const
+{
+  if ( hconn_.get_is_err() ) {
+    return true;
+  }
+  for( tcp_connect *hptr: hpool_ ) {
+    if ( hptr->get_is_err() ) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void manager::log_disconnect()
 {
   if ( hconn_.get_is_err() ) {
@@ -578,6 +927,16 @@ void manager::log_disconnect()
       .end();
     return;
   }
+  for( tcp_connect *hptr: hpool_ ) {
+    if ( hptr->get_is_err() ) {
+      PC_LOG_ERR( "rpc_http_reset")
+        .add( "error", hptr->get_err_msg() )
+        .add( "host", rhost_ )
+        .add( "port", hptr->get_port() )
+        .end();
+      return;
+    }
+  }
   if ( wconn_.get_is_err() ) {
     PC_LOG_ERR( "rpc_websocket_reset" )
       .add( "error", wconn_.get_err_msg() )
@@ -592,7 +951,11 @@ void manager::teardown_users()
 {
   while( !dlist_.empty() ) {
     user *usr = dlist_.first();
-    PC_LOG_DBG( "delete_user" ).add("fd", usr->get_fd() ).end();
+    PC_LOG_DBG( "delete_user" )
+      .add( "fd", usr->get_fd() )
+      .add( "max_send_size", usr->get_max_send_size() )
+      .add( "num_conflated", usr->get_num_conflated() )
+      .end();
     usr->close();
     dlist_.del( usr );
     delete usr;
@@ -652,11 +1015,24 @@ void manager::on_response( rpc::slot_subscribe *res )
   slot_ = slot;
   PC_LOG_DBG( "receive slot" ).add( "slot", slot_ ).end();
 
+  // send price updates coalesced during previous slot followed by
+  // those held back as they were already sent in the previous slot
+  ureq_->set_slot( slot_ );
+  submit_prices();
+  while( ureq_->release() ) {
+    submit_prices();
+  }
+
   // submit block hash every N slots
   if ( slot_cnt_++ % PC_BLOCKHASH_TIMEOUT == 0 ) {
     clnt_.send( breq_ );
   }
 
+  // refetch next batch of accounts not updated since reconnect
+  if ( is_sync_ ) {
+    resync();
+  }
+
   // reset submit
   if ( !is_pub_ ) {
     kidx_ = 0;
@@ -698,13 +1074,176 @@ void manager::on_response( rpc::program_subscribe *m )
         + m->get_err_msg()  + "]" );
     return;
   }
-  // look up by account and dispatch update
+  if ( fvec_.empty() ) {
+    // look up by account and dispatch update
+    acc_map_t::iter_t it = amap_.find( *m->get_account() );
+    if ( it ) {
+      amap_.obj( it )->on_response( m );
+    }
+  } else {
+    dispatch( m, rstat_ );
+  }
+}
+
+void manager::on_feed( rpc_feed *, rpc::slot_subscribe *m )
+{
+  if ( has_status( PC_PYTH_RPC_CONNECTED ) ) {
+    on_response( m );
+  }
+}
+
+void manager::on_feed( rpc_feed *fptr, rpc::program_subscribe *m )
+{
+  if ( has_status( PC_PYTH_RPC_CONNECTED ) ) {
+    dispatch( m, *fptr );
+  }
+}
+
+void manager::dispatch( rpc::program_subscribe *m, feed_stats& st )
+{
+  // apply only the first copy of an account update for each slot
+  if ( !race_.add( *m->get_account(), m->get_slot(), get_now(), st ) ) {
+    return;
+  }
   acc_map_t::iter_t it = amap_.find( *m->get_account() );
   if ( it ) {
     amap_.obj( it )->on_response( m );
   }
 }
 
+void manager::resync()
+{
+  // first slot after reconnect is the resync point. updates received
+  // on the new subscription from then on need no refetch
+  if ( rslot_ == 0UL ) {
+    rslot_ = slot_;
+  }
+  for( unsigned num = 0; num < PC_RESYNC_BATCH; ) {
+    request *rptr = get_resync( ridx_ );
+    if ( !rptr ) {
+      is_sync_ = false;
+      PC_LOG_INF( "completed_resync" )
+        .add( "resync_slot", rslot_ )
+        .add( "num_accounts", ridx_ )
+        .add( "num_refetch", rnum_ )
+        .add( "resync_time(ms)", 1e-6*(get_now()-rts_) )
+        .end();
+      if ( sub_ ) {
+        sub_->on_init( this );
+      }
+      return;
+    }
+    ++ridx_;
+    if ( rptr->resync( rslot_ ) ) {
+      ++rnum_;
+      ++num;
+    }
+  }
+}
+
+void manager::load_snapshot()
+{
+  // rebuild mapping, product and price accounts in snapshot order
+  pub_key *mpub = get_mapping_pub_key();
+  if ( !mpub ) {
+    return;
+  }
+  if ( !snap_.init() ) {
+    PC_LOG_INF( "no_snapshot" ).add( "error", snap_.get_err_msg() ).end();
+    snap_.reset_err();
+    return;
+  }
+  int64_t ts = get_now();
+  uint32_t num = 0;
+  add_mapping( *mpub );
+  while( snap_.get_next() && !get_is_err() ) {
+    acc_map_t::iter_t it = amap_.find( *(pub_key*)snap_.get_account() );
+    if ( it ) {
+      amap_.obj( it )->on_snapshot( &snap_ );
+      ++num;
+    }
+  }
+  if ( !has_status( PC_PYTH_HAS_MAPPING ) ) {
+    PC_LOG_ERR( "incomplete_snapshot" )
+      .add( "file", snap_.get_file() )
+      .add( "num_accounts", num )
+      .end();
+    return;
+  }
+
+  // loaded accounts need no bootstrap and are validated against the
+  // live stream by resyncing on first connect
+  for(;;) {
+    request *rptr = plist_.first();
+    if ( rptr ) {
+      rptr->set_is_submit( false );
+      plist_.del( rptr );
+    } else {
+      break;
+    }
+  }
+  is_warm_ = true;
+  PC_LOG_INF( "loaded_snapshot" )
+    .add( "file", snap_.get_file() )
+    .add( "num_accounts", num )
+    .add( "load_time(ms)", 1e-6*(get_now()-ts) )
+    .end();
+}
+
+void manager::save_snapshot()
+{
+  const pc_acc_t *img;
+  for( get_mapping *mptr: mvec_ ) {
+    if ( ( img = mptr->get_image() ) ) {
+      snap_.add( mptr->get_recv_slot(),
+          (const pc_pub_key_t*)mptr->get_mapping_key()->data(), img );
+    }
+  }
+  for( product *ptr: svec_ ) {
+    if ( ( img = ptr->get_image() ) ) {
+      snap_.add( ptr->get_recv_slot(),
+          (const pc_pub_key_t*)ptr->get_account()->data(), img );
+    }
+  }
+  for( price *ptr: pvec_ ) {
+    if ( ( img = ptr->get_image() ) ) {
+      snap_.add( ptr->get_recv_slot(),
+          (const pc_pub_key_t*)ptr->get_account()->data(), img );
+    }
+  }
+  int64_t ts = get_now();
+  uint32_t num = snap_.get_num();
+  if ( !snap_.save() ) {
+    PC_LOG_ERR( "failed_snapshot" )
+      .add( "error", snap_.get_err_msg() )
+      .end();
+    snap_.reset_err();
+    return;
+  }
+  PC_LOG_DBG( "saved_snapshot" )
+    .add( "num_accounts", num )
+    .add( "save_time(ms)", 1e-6*(get_now()-ts) )
+    .end();
+}
+
+request *manager::get_resync( unsigned idx ) const
+{
+  // walk mappings then products then prices. accounts added during
+  // resync only shift the walk back so no account is skipped
+  if ( idx < mvec_.size() ) {
+    return mvec_[idx];
+  }
+  idx -= mvec_.size();
+  if ( idx < svec_.size() ) {
+    return svec_[idx];
+  }
+  idx -= svec_.size();
+  if ( idx < pvec_.size() ) {
+    return pvec_[idx];
+  }
+  return nullptr;
+}
+
 void manager::submit( request *req )
 {
   if ( PC_UNLIKELY( req->get_is_submit() ) ) {
@@ -723,6 +1262,107 @@ void manager::submit( tx_request *req )
   tconn_.add_send( msg );
 }
 
+void manager::submit( rpc::upd_price *req )
+{
+  if ( !ureq_->add( req ) ) {
+    submit_prices();
+    ureq_->add( req );
+  }
+}
+
+void manager::submit_prices()
+{
+  if ( ureq_->get_num() ) {
+    submit( (tx_request*)ureq_ );
+    ureq_->reset();
+  }
+}
+
+void manager::poll_ingress()
+{
+  // drain at most one ring of updates per poll
+  shm::upd upd;
+  uint32_t num = ing_.get_ring_size();
+  for( uint32_t i=0; i != num && ing_.get_next( upd ); ++i ) {
+    // drop updates with out-of-range status as the binary api does
+    if ( PC_UNLIKELY( upd.status_ >=
+                      (uint32_t)symbol_status::e_last_symbol_status ) ) {
+      ++ing_inv_;
+      PC_LOG_ERR_LIMIT( "invalid ingress update", ilim_ )
+        .add( "handle", upd.handle_ )
+        .add( "status", upd.status_ )
+        .add( "num_invalid", ing_inv_ )
+        .end();
+      continue;
+    }
+    price *ptr = get_price( upd.handle_ );
+    if ( ptr ) {
+      ptr->update( upd.price_, upd.conf_, (symbol_status)upd.status_ );
+    }
+  }
+}
+
+void manager::poll_mcast()
+{
+  // cycle snapshots through all prices for receivers joining late
+  if ( has_status( PC_PYTH_HAS_MAPPING ) && !pvec_.empty() &&
+       curr_ts_ - mts_ > PC_MCAST_SNAP_INTERVAL ) {
+    mts_ = curr_ts_;
+    mcast::snap rec;
+    for( unsigned i=0; i != PC_MCAST_SNAP_BATCH && i != pvec_.size(); ++i ) {
+      if ( midx_ >= pvec_.size() ) {
+        midx_ = 0;
+      }
+      price *ptr = pvec_[midx_++];
+      get_mcast( ptr, rec.px_ );
+      __builtin_memcpy(
+          rec.acc_, ptr->get_account()->data(), sizeof( rec.acc_ ) );
+      mcst_.add( rec );
+    }
+  }
+  mcst_.flush();
+}
+
+void manager::get_mcast( price *ptr, mcast::price& rec )
+{
+  rec.handle_   = ptr->get_handle();
+  rec.status_   = (uint32_t)ptr->get_status();
+  rec.price_    = ptr->get_price();
+  rec.conf_     = ptr->get_conf();
+  rec.twap_     = ptr->get_twap();
+  rec.twac_     = ptr->get_twac();
+  rec.pub_slot_ = ptr->get_pub_slot();
+  rec.expo_     = (int32_t)ptr->get_price_exponent();
+  rec.num_qt_   = ptr->get_num_qt();
+}
+
+void manager::write( price *ptr )
+{
+  if ( do_mcast_ ) {
+    mcast::price rec;
+    get_mcast( ptr, rec );
+    mcst_.add( rec );
+  }
+  if ( !do_shm_ ) {
+    return;
+  }
+  shm::price rec;
+  __builtin_memset( &rec, 0, sizeof( rec ) );
+  __builtin_memcpy(
+      rec.acc_, ptr->get_account()->data(), sizeof( rec.acc_ ) );
+  rec.price_      = ptr->get_price();
+  rec.conf_       = ptr->get_conf();
+  rec.twap_       = ptr->get_twap();
+  rec.twac_       = ptr->get_twac();
+  rec.valid_slot_ = ptr->get_valid_slot();
+  rec.pub_slot_   = ptr->get_pub_slot();
+  rec.ts_         = get_now();
+  rec.status_     = (uint32_t)ptr->get_status();
+  rec.num_qt_     = ptr->get_num_qt();
+  rec.expo_       = (int32_t)ptr->get_price_exponent();
+  shm_.update( ptr->get_handle(), rec );
+}
+
 void manager::on_connect()
 {
   // callback user with connection status
@@ -749,6 +1389,7 @@ void manager::add_product( const pub_key&acc )
     product *ptr = new product( acc );
     amap_.ref( amap_.add( acc ) ) = ptr;
     svec_.push_back( ptr );
+    inval_product_list();
     submit( ptr );
     // add mapping subscription count
     add_map_sub();
@@ -769,9 +1410,12 @@ void manager::add_price( const pub_key&acc, product *prod )
     // get info for new price account
     price *ptr = new price( acc, prod );
     amap_.ref( amap_.add( acc ) ) = ptr;
+    ptr->set_handle( pvec_.size() );
+    pvec_.push_back( ptr );
     submit( ptr );
     // add price to product
     prod->add_price( ptr );
+    inval_product_list();
     // add mapping subscription count
     add_map_sub();
   }
@@ -783,6 +1427,77 @@ price *manager::get_price( const pub_key& acc )
   return it ? dynamic_cast<price*>( amap_.obj( it ) ) : nullptr;
 }
 
+void manager::inval_product_list()
+{
+  if ( plist_ok_ ) {
+    plist_ok_ = false;
+    ++plist_ver_;
+  }
+}
+
+uint64_t manager::get_product_list_version() const
+{
+  return plist_ver_;
+}
+
+str manager::get_product_list()
+{
+  if ( plist_ok_ ) {
+    return plist_buf_;
+  }
+  json_wtr jw;
+  jw.add_val( json_wtr::e_arr );
+  for( product *prod: svec_ ) {
+    jw.add_val( json_wtr::e_obj );
+    jw.add_key( "account", *prod->get_account() );
+    jw.add_key( "attr_dict", json_wtr::e_obj );
+    prod->write_json( jw );
+    jw.pop();
+    jw.add_key( "price", json_wtr::e_arr );
+    for( unsigned j=0; j != prod->get_num_price(); ++j ) {
+      jw.add_val( json_wtr::e_obj );
+      price *px = prod->get_price( j );
+      int64_t expo = px->get_price_exponent();
+      price_type ptype = px->get_price_type();
+      jw.add_key( "account", *px->get_account() );
+      jw.add_key( "handle", (uint64_t)px->get_handle() );
+      jw.add_key( "price_exponent", expo );
+      jw.add_key( "price_type", price_type_to_str( ptype) );
+      jw.pop();
+    }
+    jw.pop();
+    jw.pop();
+  }
+  jw.pop();
+
+  // flatten into single buffer
+  net_buf *hd, *tl;
+  jw.detach( hd, tl );
+  plist_buf_.clear();
+  while( hd ) {
+    net_buf *nxt = hd->next_;
+    plist_buf_.append( hd->buf_, hd->size_ );
+    hd->dealloc();
+    hd = nxt;
+  }
+  plist_ok_ = true;
+  PC_LOG_DBG( "render_product_list" )
+    .add( "version", plist_ver_ )
+    .add( "num_bytes", plist_buf_.size() )
+    .end();
+  return plist_buf_;
+}
+
+unsigned manager::get_num_price() const
+{
+  return pvec_.size();
+}
+
+price *manager::get_price( uint32_t hdl ) const
+{
+  return hdl < pvec_.size() ? pvec_[hdl] : nullptr;
+}
+
 unsigned manager::get_num_product() const
 {
   return svec_.size();
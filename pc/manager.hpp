@@ -8,6 +8,12 @@
 #include <pc/dbl_list.hpp>
 #include <pc/hash_map.hpp>
 #include <pc/capture.hpp>
+#include <pc/rpc_feed.hpp>
+#include <pc/snapshot.hpp>
+#include <pc/shm_price.hpp>
+#include <pc/shm_upd.hpp>
+#include <pc/mcast.hpp>
+#include <pc/log.hpp>
 
 // status bits
 #define PC_PYTH_RPC_CONNECTED    (1<<0)
@@ -50,7 +56,8 @@ namespace pc
                   public rpc_sub,
                   public rpc_sub_i<rpc::slot_subscribe>,
                   public rpc_sub_i<rpc::get_recent_block_hash>,
-                  public rpc_sub_i<rpc::program_subscribe>
+                  public rpc_sub_i<rpc::program_subscribe>,
+                  public rpc_feed_sub
   {
   public:
 
@@ -61,6 +68,20 @@ namespace pc
     void set_rpc_host( const std::string& );
     std::string get_rpc_host() const;
 
+    // additional rpc node racing the primary rpc host to deliver slot
+    // and account updates. the first update of an account for a given
+    // slot is applied and later copies are dropped. add before init()
+    void add_rpc_feed( const std::string& host );
+
+    // race statistics of primary rpc host and of additional feeds
+    const feed_stats& get_rpc_stats() const;
+    unsigned get_num_rpc_feed() const;
+    rpc_feed *get_rpc_feed( unsigned ) const;
+
+    // number of pooled rpc http connections (default 1)
+    void set_num_http_conn( unsigned );
+    unsigned get_num_http_conn() const;
+
     // pyth transaction proxy host
     void set_tx_host( const std::string& );
     std::string get_tx_host() const;
@@ -69,6 +90,18 @@ namespace pc
     void set_do_tx( bool );
     bool get_do_tx() const;
 
+    // hold price updates until the next slot so only the latest update
+    // per symbol is sent once per slot, stamped with the slot it is sent
+    // in (off by default: updates are sent at the end of each poll)
+    void set_do_coalesce( bool );
+    bool get_do_coalesce() const;
+
+    // on rpc reconnect keep accounts live, resubscribe and refetch in
+    // batches only accounts not updated since the reconnect slot instead
+    // of re-bootstrapping all accounts (off by default)
+    void set_do_resync( bool );
+    bool get_do_resync() const;
+
     // server listening port
     void set_listen_port( int port );
     int get_listen_port() const;
@@ -89,6 +122,30 @@ namespace pc
     void set_capture_file( const std::string& cap_file );
     std::string get_capture_file() const;
 
+    // warm-start snapshot file. if set, accounts are loaded from the
+    // snapshot in init() and validated against live updates on connect.
+    // the snapshot is saved periodically and on teardown
+    void set_snapshot_file( const std::string& );
+    std::string get_snapshot_file() const;
+
+    // shared-memory price feed file (off if not set). every aggregate
+    // price update is written to the region for co-located readers
+    void set_shm_file( const std::string& );
+    std::string get_shm_file() const;
+
+    // shared-memory ring for price updates from local publishers (off
+    // if not set). updates are drained every poll into price::update()
+    void set_shm_ingress_file( const std::string& );
+    std::string get_shm_ingress_file() const;
+
+    // number of ingress updates dropped for invalid symbol_status
+    uint64_t get_num_ingress_invalid() const;
+
+    // udp multicast group for aggregate prices as ip_addr:port (off if
+    // not set). all prices are also re-sent periodically as snapshots
+    void set_mcast_addr( const std::string& );
+    std::string get_mcast_addr() const;
+
     // override default publish interval (in milliseconds)
     void set_publish_interval( int64_t mill_secs );
     int64_t get_publish_interval() const;
@@ -124,10 +181,24 @@ namespace pc
     product *get_product( const pub_key& );
     price   *get_price( const pub_key& );
 
+    // dense table of all prices indexed by price::get_handle()
+    unsigned get_num_price() const;
+    price   *get_price( uint32_t handle ) const;
+
+    // pre-rendered get_product_list result shared by all users
+    // rebuilt on first use after the product or price graph changes
+    str get_product_list();
+    uint64_t get_product_list_version() const;
+    void inval_product_list();
+
     // submit pyth client api request
     void submit( request * );
     void submit( tx_request * );
 
+    // queue price update to be packed with other updates into one
+    // transaction that is sent at the end of poll()
+    void submit( rpc::upd_price * );
+
     // check status condition
     bool has_status( int status ) const;
 
@@ -156,6 +227,7 @@ namespace pc
     void del_map_sub();
     void schedule( price_sched* );
     void write( pc_pub_key_t *, pc_acc_t *ptr );
+    void write( price * );
 
     // tx_sub callbacks
     void on_connect() override;
@@ -167,6 +239,8 @@ namespace pc
     void on_response( rpc::slot_subscribe * ) override;
     void on_response( rpc::get_recent_block_hash * ) override;
     void on_response( rpc::program_subscribe * ) override;
+    void on_feed( rpc_feed *, rpc::slot_subscribe * ) override;
+    void on_feed( rpc_feed *, rpc::program_subscribe * ) override;
     void set_status( int );
     get_mapping *get_last_mapping() const;
 
@@ -196,17 +270,34 @@ namespace pc
     typedef dbl_list<request>         req_list_t;
     typedef std::vector<get_mapping*> map_vec_t;
     typedef std::vector<product*>     spx_vec_t;
+    typedef std::vector<price*>       px_vec_t;
     typedef std::vector<price_sched*> kpx_vec_t;
+    typedef std::vector<tcp_connect*> http_vec_t;
+    typedef std::vector<rpc_feed*>    feed_vec_t;
     typedef hash_map<trait_account>   acc_map_t;
 
     void reconnect_rpc();
     void log_disconnect();
     void teardown_users();
     void poll_schedule();
+    void submit_prices();
+    bool get_is_http_err() const;
+    bool get_is_feed_live() const;
+    bool reconnect_ws();
+    void dispatch( rpc::program_subscribe *, feed_stats& );
+    void resync();
+    request *get_resync( unsigned ) const;
+    void load_snapshot();
+    void save_snapshot();
+    void poll_ingress();
+    void poll_mcast();
+    void get_mcast( price *, mcast::price& );
     void reset_status( int );
 
     net_loop     nl_;       // epoll loop
     tcp_connect  hconn_;    // rpc http connection
+    http_vec_t   hpool_;    // additional pooled rpc http connections
+    unsigned     nhttp_;    // number of rpc http connections
     ws_connect   wconn_;    // rpc websocket sonnection
     tcp_listen   lsvr_;     // listening socket
     rpc_client   clnt_;     // rpc api
@@ -217,6 +308,7 @@ namespace pc
     map_vec_t    mvec_;     // mapping account updates
     acc_map_t    amap_;     // account to symbol pricing info
     spx_vec_t    svec_;     // symbol price subscriber/publishers
+    px_vec_t     pvec_;     // prices indexed by handle
     std::string  thost_;    // tx proxy host
     std::string  rhost_;    // rpc host
     std::string  cdir_;     // content directory
@@ -235,15 +327,44 @@ namespace pc
     bool         wait_conn_;// waiting on connection
     bool         do_cap_;   // do capture flag
     bool         do_tx_;    // do tx proxy connectivity
+    bool         do_coal_;  // coalesce price updates per slot
     bool         is_pub_;   // is publishing mode
     capture      cap_;      // aggregate price capture
     tx_parser    txp_;      // handle unexpected errors
     commitment   cmt_;      // account get/subscribe commitment
+    feed_vec_t   fvec_;     // additional racing rpc feeds
+    feed_race    race_;     // latest account update slot across feeds
+    feed_stats   rstat_;    // race statistics of primary rpc host
+    ws_failover  wfo_;      // primary websocket failover to feeds
+    bool         do_sync_;  // resync accounts on reconnect
+    bool         is_sync_;  // resync in progress
+    uint32_t     ridx_;     // resync account index
+    uint32_t     rnum_;     // number of accounts refetched
+    uint64_t     rslot_;    // resync reconnect slot
+    int64_t      rts_;      // resync start time
+    snapshot     snap_;     // warm-start snapshot
+    bool         do_snap_;  // save warm-start snapshot
+    bool         is_warm_;  // accounts loaded from snapshot
+    int64_t      sts_;      // snapshot save timestamp
+    shm_price_wtr shm_;     // shared-memory price feed
+    bool         do_shm_;   // write shared-memory price feed
+    shm_upd_rdr  ing_;      // shared-memory price update ingress
+    bool         do_ing_;   // read shared-memory price updates
+    uint64_t     ing_inv_;  // number of invalid ingress updates
+    log_limit    ilim_;     // invalid ingress update log rate limit
+    mcast_pub    mcst_;     // multicast price feed
+    bool         do_mcast_; // send multicast price feed
+    uint32_t     midx_;     // multicast snapshot price index
+    int64_t      mts_;      // multicast snapshot timestamp
+    std::string  plist_buf_;// rendered product list
+    uint64_t     plist_ver_;// product list version
+    bool         plist_ok_; // rendered product list is current
 
     // requests
     rpc::slot_subscribe        sreq_[1]; // slot subscription
     rpc::get_recent_block_hash breq_[1]; // block hash request
     rpc::program_subscribe     preq_[1]; // program account subscription
+    rpc::upd_prices            ureq_[1]; // packed price updates
   };
 
   inline bool manager::get_is_tx_connect() const
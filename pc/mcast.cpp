@@ -0,0 +1,317 @@
+#include "mcast.hpp"
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+#define PC_MCAST_MAX_HANDLE 1048576
+
+using namespace pc;
+
+///////////////////////////////////////////////////////////////////////////
+// mcast_pub
+
+mcast_pub::mcast_pub()
+: ttl_( 1 ),
+  session_( 0L ),
+  seq_( 0UL ),
+  len_( 0 ),
+  num_( 0 ),
+  hdr_( nullptr )
+{
+}
+
+void mcast_pub::set_addr( const std::string& addr )
+{
+  addr_ = addr;
+}
+
+std::string mcast_pub::get_addr() const
+{
+  return addr_;
+}
+
+void mcast_pub::set_ttl( int ttl )
+{
+  ttl_ = ttl;
+}
+
+int mcast_pub::get_ttl() const
+{
+  return ttl_;
+}
+
+uint64_t mcast_pub::get_seq() const
+{
+  return seq_;
+}
+
+int64_t mcast_pub::get_session() const
+{
+  return session_;
+}
+
+bool mcast_pub::init()
+{
+  if ( addr_.find( ':' ) == std::string::npos ) {
+    return set_err_msg( "invalid multicast address=" + addr_ );
+  }
+  ip_ = ip_addr( addr_ );
+  if ( !sock_.init() || !sock_.set_mcast( ttl_, true ) ) {
+    return set_err_msg( sock_.get_err_msg() );
+  }
+  buf_.resize( udp_socket::max_batch * mcast::max_size );
+  session_ = get_now();
+  seq_ = 0UL;
+  len_ = num_ = 0;
+  hdr_ = nullptr;
+  return true;
+}
+
+void mcast_pub::add( const mcast::price& rec )
+{
+  add( mcast::e_update, rec );
+}
+
+void mcast_pub::add( const mcast::snap& rec )
+{
+  add( mcast::e_snapshot, rec );
+}
+
+template<class T>
+void mcast_pub::add( uint16_t type, const T& rec )
+{
+  if ( hdr_ && ( hdr_->type_ != type ||
+                 len_ + sizeof( T ) > mcast::max_size ) ) {
+    commit();
+  }
+  if ( !hdr_ ) {
+    if ( num_ == udp_socket::max_batch ) {
+      flush();
+    }
+    hdr_ = (mcast::hdr*)&buf_[num_ * mcast::max_size];
+    hdr_->magic_   = mcast::magic;
+    hdr_->type_    = type;
+    hdr_->num_     = 0;
+    hdr_->session_ = session_;
+    hdr_->seq_     = seq_++;
+    len_ = sizeof( mcast::hdr );
+  }
+  __builtin_memcpy( (char*)hdr_ + len_, &rec, sizeof( T ) );
+  len_ += sizeof( T );
+  hdr_->num_++;
+}
+
+void mcast_pub::commit()
+{
+  hdr_->ts_ = get_now();
+  iov_[num_].iov_base = hdr_;
+  iov_[num_].iov_len  = len_;
+  ++num_;
+  hdr_ = nullptr;
+}
+
+void mcast_pub::flush()
+{
+  if ( hdr_ ) {
+    commit();
+  }
+  if ( num_ ) {
+    // datagrams that cannot be sent are dropped and show up as gaps
+    sock_.send( &ip_, iov_, num_ );
+    num_ = 0;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////
+// mcast_sub
+
+mcast_sub::mcast_sub()
+: session_( 0L ),
+  seq_( 0UL ),
+  num_recv_( 0UL ),
+  num_upd_( 0UL ),
+  num_snap_( 0UL ),
+  num_gap_( 0UL ),
+  num_restart_( 0UL )
+{
+}
+
+void mcast_sub::set_addr( const std::string& addr )
+{
+  addr_ = addr;
+}
+
+std::string mcast_sub::get_addr() const
+{
+  return addr_;
+}
+
+uint64_t mcast_sub::get_num_recv() const
+{
+  return num_recv_;
+}
+
+uint64_t mcast_sub::get_num_upd() const
+{
+  return num_upd_;
+}
+
+uint64_t mcast_sub::get_num_snap() const
+{
+  return num_snap_;
+}
+
+uint64_t mcast_sub::get_num_gap() const
+{
+  return num_gap_;
+}
+
+uint64_t mcast_sub::get_num_restart() const
+{
+  return num_restart_;
+}
+
+bool mcast_sub::init()
+{
+  close();
+  reset_err();
+  if ( addr_.find( ':' ) == std::string::npos ) {
+    return set_err_msg( "invalid multicast address=" + addr_ );
+  }
+  ip_addr ip( addr_ );
+  sockaddr_in *gaddr = (sockaddr_in*)ip.buf_;
+  int fd = ::socket( AF_INET, SOCK_DGRAM, IPPROTO_UDP );
+  if ( fd < 0 ) {
+    return set_err_msg( "failed to construct udp socket", errno );
+  }
+  set_fd( fd );
+  int reuse = 1;
+  ::setsockopt( fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof( reuse ) );
+
+  // bind to group address so that only this group is received
+  sockaddr_in saddr[1];
+  __builtin_memset( saddr, 0, sizeof( saddr ) );
+  saddr->sin_family = AF_INET;
+  saddr->sin_port   = gaddr->sin_port;
+  saddr->sin_addr   = gaddr->sin_addr;
+  if ( 0 != ::bind( fd, (sockaddr*)saddr, sizeof( saddr ) ) ) {
+    return set_err_msg( "failed to bind address=" + addr_, errno );
+  }
+  if ( IN_MULTICAST( ntohl( gaddr->sin_addr.s_addr ) ) ) {
+    ip_mreq mreq[1];
+    mreq->imr_multiaddr = gaddr->sin_addr;
+    mreq->imr_interface.s_addr = htonl( INADDR_ANY );
+    if ( 0 != ::setsockopt(
+          fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, mreq, sizeof( mreq ) ) ) {
+      return set_err_msg( "failed to join group=" + addr_, errno );
+    }
+  }
+  set_block( false );
+  if ( get_net_loop() ) {
+    get_net_loop()->add( this, EPOLLIN );
+  }
+  return true;
+}
+
+void mcast_sub::poll()
+{
+  char buf[mcast::max_size];
+  for(;;) {
+    ssize_t len = ::recv( get_fd(), buf, sizeof( buf ), 0 );
+    if ( len <= 0 ) {
+      break;
+    }
+    parse( buf, len );
+  }
+}
+
+mcast_sub::entry& mcast_sub::get_entry( uint32_t hdl )
+{
+  if ( hdl >= pvec_.size() ) {
+    entry ent;
+    __builtin_memset( &ent, 0, sizeof( ent ) );
+    pvec_.resize( hdl + 1, ent );
+  }
+  return pvec_[hdl];
+}
+
+void mcast_sub::parse( const char *buf, size_t len )
+{
+  const mcast::hdr *hptr = (const mcast::hdr*)buf;
+  if ( len < sizeof( mcast::hdr ) || hptr->magic_ != mcast::magic ) {
+    return;
+  }
+  size_t rlen = hptr->type_ == mcast::e_update ?
+    sizeof( mcast::price ) : sizeof( mcast::snap );
+  if ( ( hptr->type_ != mcast::e_update &&
+         hptr->type_ != mcast::e_snapshot ) ||
+       len < sizeof( mcast::hdr ) + hptr->num_ * rlen ) {
+    return;
+  }
+
+  // late datagrams of a previous publisher session are dropped
+  if ( num_recv_ && hptr->session_ < session_ ) {
+    return;
+  }
+
+  // first datagram of a session only sets the sequence expectation.
+  // a restarted publisher reuses handles so prices start over too
+  if ( !num_recv_ || hptr->session_ != session_ ) {
+    if ( num_recv_ ) {
+      pvec_.clear();
+      ++num_restart_;
+    }
+    session_ = hptr->session_;
+    seq_ = hptr->seq_ + 1UL;
+  } else {
+    if ( hptr->seq_ > seq_ ) {
+      num_gap_ += hptr->seq_ - seq_;
+    }
+    if ( hptr->seq_ >= seq_ ) {
+      seq_ = hptr->seq_ + 1UL;
+    }
+  }
+  ++num_recv_;
+
+  const char *ptr = buf + sizeof( mcast::hdr );
+  for( unsigned i=0; i != hptr->num_; ++i, ptr += rlen ) {
+    const mcast::price *px = (const mcast::price*)ptr;
+    if ( px->handle_ >= PC_MCAST_MAX_HANDLE ) {
+      continue;
+    }
+    entry& ent = get_entry( px->handle_ );
+    if ( hptr->type_ == mcast::e_snapshot ) {
+      const mcast::snap *sn = (const mcast::snap*)ptr;
+      __builtin_memcpy( ent.sn_.acc_, sn->acc_, sizeof( sn->acc_ ) );
+      ent.has_acc_ = true;
+      ++num_snap_;
+      // snapshot does not override a more recent update
+      if ( ent.has_px_ && ent.sn_.px_.pub_slot_ > px->pub_slot_ ) {
+        continue;
+      }
+    } else {
+      ++num_upd_;
+    }
+    ent.sn_.px_ = *px;
+    ent.has_px_ = true;
+  }
+}
+
+bool mcast_sub::get_price( uint32_t hdl, mcast::price& res ) const
+{
+  if ( hdl >= pvec_.size() || !pvec_[hdl].has_px_ ) {
+    return false;
+  }
+  res = pvec_[hdl].sn_.px_;
+  return true;
+}
+
+const uint8_t *mcast_sub::get_account( uint32_t hdl ) const
+{
+  if ( hdl >= pvec_.size() || !pvec_[hdl].has_acc_ ) {
+    return nullptr;
+  }
+  return pvec_[hdl].sn_.acc_;
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <pc/net_socket.hpp>
+#include <vector>
+
+namespace pc
+{
+
+  // udp multicast distribution of aggregate prices. each datagram is a
+  // hdr followed by num_ records. datagram sequence numbers are shared
+  // by update and snapshot datagrams so receivers can detect gaps and
+  // restart from zero with each new publisher session. snapshot
+  // datagrams cycle through all prices for late joiners
+  namespace mcast
+  {
+    static const uint32_t magic    = 0x6d747970; // "pytm"
+    static const size_t   max_size = 1400;       // max datagram size
+
+    // datagram types
+    enum : uint16_t {
+      e_update   = 1,       // mcast::price records
+      e_snapshot = 2        // mcast::snap records
+    };
+
+    struct hdr
+    {
+      uint32_t magic_;        // mcast::magic
+      uint16_t type_;         // datagram type
+      uint16_t num_;          // number of records
+      int64_t  session_;      // publisher start time in nanoseconds
+      uint64_t seq_;          // datagram sequence number within session
+      int64_t  ts_;           // send time in nanoseconds from epoch
+    } PC_PACKED;
+
+    struct price
+    {
+      uint32_t handle_;       // price handle
+      uint32_t status_;       // aggregate symbol_status
+      int64_t  price_;        // aggregate price
+      uint64_t conf_;         // aggregate confidence interval
+      int64_t  twap_;         // time-weighted average price
+      uint64_t twac_;         // time-weighted average confidence
+      uint64_t pub_slot_;     // publish slot of aggregate
+      int32_t  expo_;         // price exponent
+      uint32_t num_qt_;       // number of quoters in aggregate
+    } PC_PACKED;
+
+    struct snap
+    {
+      price    px_;           // latest aggregate
+      uint8_t  acc_[32];      // price account key
+    } PC_PACKED;
+  }
+
+  // multicast publisher batching records into datagrams
+  class mcast_pub : public error
+  {
+  public:
+
+    mcast_pub();
+
+    // destination group in the form ip_addr:port
+    void set_addr( const std::string& );
+    std::string get_addr() const;
+
+    // multicast time-to-live (default 1)
+    void set_ttl( int );
+    int get_ttl() const;
+
+    // create sending socket
+    bool init();
+
+    // add record to current datagram of given type
+    void add( const mcast::price& );
+    void add( const mcast::snap& );
+
+    // send all pending datagrams
+    void flush();
+
+    // number of datagrams sent
+    uint64_t get_seq() const;
+
+    // session id (time of init) stamped on every datagram
+    int64_t get_session() const;
+
+  private:
+    template<class T> void add( uint16_t type, const T& );
+    void commit();
+
+    std::string       addr_;
+    ip_addr           ip_;
+    int               ttl_;
+    int64_t           session_;
+    uint64_t          seq_;
+    size_t            len_;
+    unsigned          num_;
+    mcast::hdr       *hdr_;
+    udp_socket        sock_;
+    std::vector<char> buf_;
+    iovec             iov_[udp_socket::max_batch];
+  };
+
+  // reference multicast receiver tracking latest price per handle
+  class mcast_sub : public net_socket
+  {
+  public:
+
+    mcast_sub();
+
+    // group to join in the form ip_addr:port (unicast also accepted)
+    void set_addr( const std::string& );
+    std::string get_addr() const;
+
+    // bind and join group
+    bool init() override;
+
+    // read all available datagrams
+    void poll() override;
+
+    // latest price by handle (false if not received)
+    bool get_price( uint32_t hdl, mcast::price& ) const;
+
+    // price account key by handle (nullptr if no snapshot yet)
+    const uint8_t *get_account( uint32_t hdl ) const;
+
+    // datagram and record counts
+    uint64_t get_num_recv() const;
+    uint64_t get_num_upd() const;
+    uint64_t get_num_snap() const;
+
+    // number of datagrams lost according to sequence numbers
+    uint64_t get_num_gap() const;
+
+    // number of publisher restarts (new session ids) seen
+    uint64_t get_num_restart() const;
+
+  private:
+    struct entry {
+      mcast::snap sn_;
+      bool        has_px_;
+      bool        has_acc_;
+    };
+
+    void parse( const char *, size_t );
+    entry& get_entry( uint32_t );
+
+    std::string        addr_;
+    int64_t            session_;
+    uint64_t           seq_;
+    uint64_t           num_recv_;
+    uint64_t           num_upd_;
+    uint64_t           num_snap_;
+    uint64_t           num_gap_;
+    uint64_t           num_restart_;
+    std::vector<entry> pvec_;
+  };
+
+}
@@ -1,6 +1,7 @@
 #include "misc.hpp"
 #include <ctype.h>
 #include <time.h>
+#include <algorithm>
 
 namespace pc
 {
@@ -92,6 +93,119 @@ int dec_base58( const uint8_t *str, int len, uint8_t *result)
   return resultlen;
 }
 
+// fixed-length conversions work on big-endian 32-bit limbs with 64-bit
+// intermediates, converting 5 base58 digits (58^5 < 2^32) per pass
+static const uint32_t b58_pow[6] = {
+  1U, 58U, 3364U, 195112U, 11316496U, 656356768U
+};
+
+template<unsigned N>
+struct b58_fixed
+{
+  static const unsigned nlimb = N/4;
+  static const unsigned ndig  = N == 32 ? 44 : 88; // max encoded digits
+  static const unsigned nchnk = (ndig+4)/5;
+};
+
+template<unsigned N>
+int enc_base58_fixed( const uint8_t *src, uint8_t *result, int reslen )
+{
+  typedef b58_fixed<N> fx;
+  uint32_t limb[fx::nlimb];
+  uint8_t  dig[5*fx::nchnk];
+  unsigned zeros = 0, beg = 0;
+  while( zeros != N && !src[zeros] ) ++zeros;
+  for( unsigned i=0; i != fx::nlimb; ++i ) {
+    uint32_t v;
+    __builtin_memcpy( &v, &src[4*i], sizeof( v ) );
+    limb[i] = __builtin_bswap32( v );
+  }
+
+  // repeated long division by 58^5 yields 5 digits per pass
+  // starting from least significant
+  unsigned nchnk = 0;
+  for( beg = zeros/4; beg != fx::nlimb; ++nchnk ) {
+    uint64_t rem = 0;
+    for( unsigned i=beg; i != fx::nlimb; ++i ) {
+      uint64_t cur = ( rem << 32 ) | limb[i];
+      limb[i] = (uint32_t)( cur / b58_pow[5] );
+      rem = cur % b58_pow[5];
+    }
+    while( beg != fx::nlimb && !limb[beg] ) ++beg;
+    uint32_t r = (uint32_t)rem;
+    for( unsigned j=0; j != 5; ++j ) {
+      dig[5*nchnk+j] = r % 58;
+      r /= 58;
+    }
+  }
+
+  // strip leading zero digits and write text
+  unsigned ndig = 5*nchnk;
+  while( ndig && !dig[ndig-1] ) --ndig;
+  if ( (int)( zeros + ndig + 1 ) > reslen ) return 0;
+  uint8_t *ptr = result;
+  for( unsigned i=0; i != zeros; ++i ) *ptr++ = '1';
+  while( ndig ) *ptr++ = ALPHABET[dig[--ndig]];
+  *ptr = 0;
+  return ptr - result;
+}
+
+template<unsigned N>
+int dec_base58_fixed( const uint8_t *str, int len, uint8_t *result )
+{
+  // anything other than well-formed text of exactly N bytes takes
+  // the generic path so results (and return value) are unchanged
+  typedef b58_fixed<N> fx;
+  if ( len <= 0 || len > (int)fx::ndig ) {
+    return dec_base58( str, len, result );
+  }
+  uint32_t limb[fx::nlimb+1]; // least significant first
+  __builtin_memset( limb, 0, sizeof( limb ) );
+  unsigned zeros = 0, top = 0;
+  while( (int)zeros != len && str[zeros] == '1' ) ++zeros;
+  for( int i=0; i < len; ) {
+    unsigned k = std::min( 5, len - i );
+    uint32_t val = 0;
+    for( unsigned j=0; j != k; ++j, ++i ) {
+      int d = ALPHABET_MAP[str[i]];
+      if ( d < 0 ) {
+        return dec_base58( str, len, result );
+      }
+      val = val*58 + d;
+    }
+    uint64_t carry = val, mul = b58_pow[k];
+    for( unsigned j=0; j <= top; ++j ) {
+      uint64_t cur = mul * limb[j] + carry;
+      limb[j] = (uint32_t)cur;
+      carry = cur >> 32;
+    }
+    if ( carry ) {
+      if ( ++top > fx::nlimb ) {
+        return dec_base58( str, len, result );
+      }
+      limb[top] = (uint32_t)carry;
+    }
+  }
+
+  // minimal byte length of number (at least one) plus leading zeros
+  unsigned nbyte = 4*top;
+  for( uint32_t v = limb[top]; v; v >>= 8 ) ++nbyte;
+  if ( nbyte == 0 ) nbyte = 1;
+  if ( top == fx::nlimb || zeros + nbyte != N ) {
+    return dec_base58( str, len, result );
+  }
+  for( unsigned i=0; i != fx::nlimb; ++i ) {
+    uint32_t v = __builtin_bswap32( limb[fx::nlimb-1-i] );
+    __builtin_memcpy( &result[4*i], &v, sizeof( v ) );
+  }
+  return N;
+}
+
+template int enc_base58_fixed<32>( const uint8_t *, uint8_t *, int );
+template int enc_base58_fixed<64>( const uint8_t *, uint8_t *, int );
+template int dec_base58_fixed<32>( const uint8_t *, int, uint8_t * );
+template int dec_base58_fixed<64>( const uint8_t *, int, uint8_t * );
+
 char *uint_to_str( uint64_t val, char *cptr )
 {
   if ( val ) {
@@ -15,6 +15,13 @@ namespace pc
   int enc_base58( const uint8_t *src, int len, uint8_t *result, int rlen);
   int dec_base58( const uint8_t *str, int len, uint8_t *result );
 
+  // fixed-length base58 codecs for N=32 byte keys and N=64 byte
+  // signatures with results identical to the above
+  template<unsigned N>
+  int enc_base58_fixed( const uint8_t *src, uint8_t *result, int rlen );
+  template<unsigned N>
+  int dec_base58_fixed( const uint8_t *str, int len, uint8_t *result );
+
   // base64 encoding courtesy of
   // Adam Rudd per licence: github.com/adamvr/arduino-base64
   int enc_base64_len( int len );
@@ -281,10 +281,20 @@ bool net_loop::poll( int timeout )
 ///////////////////////////////////////////////////////////////////////////
 // net_socket
 
+net_parser::net_parser()
+: need_( 0 )
+{
+}
+
 net_parser::~net_parser()
 {
 }
 
+void net_parser::reset()
+{
+  need_ = 0;
+}
+
 net_socket::~net_socket()
 {
 }
@@ -371,14 +381,83 @@ bool net_socket::init()
   return true;
 }
 
+///////////////////////////////////////////////////////////////////////////
+// net_rbuf
+
+net_rbuf::net_rbuf()
+: buf_( nullptr ),
+  cap_( 0 ),
+  beg_( 0 ),
+  end_( 0 ),
+  nrecv_( 0 ),
+  rbytes_( 0 ),
+  mrecv_( 0 ),
+  mbytes_( 0 ),
+  nalloc_( 0 )
+{
+}
+
+net_rbuf::~net_rbuf()
+{
+  delete [] buf_;
+}
+
+char *net_rbuf::reserve( size_t len, size_t& avail )
+{
+  len = len > min_free ? len : min_free;
+  size_t sz = end_ - beg_;
+  if ( cap_ - end_ < len ) {
+    if ( cap_ - sz >= len && sz <= cap_/2 ) {
+      // enough room once parsed bytes are dropped from front
+      __builtin_memmove( buf_, &buf_[beg_], sz );
+      mbytes_ += sz;
+    } else {
+      // grow geometrically to fit message being read
+      size_t cap = std::max( 2*cap_, sz + len );
+      cap = cap > min_len ? cap : min_len;
+      char *buf = new char[cap];
+      __builtin_memcpy( buf, &buf_[beg_], sz );
+      delete [] buf_;
+      buf_ = buf;
+      cap_ = cap;
+      mbytes_ += sz;
+      ++nalloc_;
+    }
+    beg_ = 0;
+    end_ = sz;
+  }
+  avail = cap_ - end_;
+  return &buf_[end_];
+}
+
+void net_rbuf::consume( size_t len )
+{
+  beg_ += len;
+  if ( beg_ >= end_ ) {
+    beg_ = end_ = 0;
+    // release oversized buffer once idle
+    if ( cap_ > max_idle ) {
+      delete [] buf_;
+      buf_ = nullptr;
+      cap_ = 0;
+    }
+  }
+}
+
+void net_rbuf::reset()
+{
+  beg_ = end_ = 0;
+}
+
 ///////////////////////////////////////////////////////////////////////////
 // net_connect
 
 net_connect::net_connect()
 : whd_( nullptr ),
   wtl_( nullptr ),
-  rsz_( 0 ),
   wsz_( 0 ),
+  wnum_( 0 ),
+  wmax_( 0 ),
   np_( nullptr )
 {
 }
@@ -386,6 +465,9 @@ net_connect::net_connect()
 void net_connect::set_net_parser( net_parser *np )
 {
   np_ = np;
+  if ( np_ ) {
+    np_->reset();
+  }
 }
 
 net_parser *net_connect::get_net_parser() const
@@ -398,10 +480,24 @@ bool net_connect::get_is_send() const
   return whd_ != nullptr;
 }
 
+size_t net_connect::get_send_size() const
+{
+  return wnum_;
+}
+
+size_t net_connect::get_max_send_size() const
+{
+  return wmax_;
+}
+
 void net_connect::add_send( net_wtr& msg )
 {
   net_buf *hd, *tl;
   msg.detach( hd, tl );
+  for( net_buf *ptr = hd; ptr; ptr = ptr->next_ ) {
+    wnum_ += ptr->size_;
+  }
+  wmax_ = wnum_ > wmax_ ? wnum_ : wmax_;
   if ( wtl_ ) {
     wtl_->next_ = hd;
   } else {
@@ -433,6 +529,7 @@ void net_connect::poll_send()
     int rc = ::send( get_fd(), ptr, len, MSG_NOSIGNAL );
     if ( rc > 0 ) {
       wsz_ += rc;
+      wnum_ -= rc;
 
       // advance to next buffer in list
       if ( wsz_ == whd_->size_ ) {
@@ -460,32 +557,26 @@ void net_connect::poll_send()
 void net_connect::poll_recv()
 {
   while( !get_is_err() ) {
-    // extend read buffer as required
-    size_t len = rdr_.size() - rsz_;
-    if ( len < buf_len ) {
-      rdr_.resize( rdr_.size() + buf_len );
-    }
-    // read up to buf_len at a time
-    ssize_t rc = ::recv( get_fd(), &rdr_[rsz_], buf_len, MSG_NOSIGNAL );
+    // read into all free space, growing to fit incomplete message
+    size_t avail = 0, need = np_->get_need(), sz = rdr_.size();
+    char *ptr = rdr_.reserve( need > sz ? need - sz : 0, avail );
+    ssize_t rc = ::recv( get_fd(), ptr, avail, MSG_NOSIGNAL );
     if ( rc > 0 ) {
-      rsz_ += rc;
+      rdr_.advance( rc );
     } else {
       if ( rc == 0 || errno != EAGAIN ) {
         poll_error( true );
       }
       break;
     }
-    // parse content
-    for( size_t idx=0; !get_is_err() && rsz_; ) {
+    // parse content once enough is buffered for the pending message
+    while( !get_is_err() && rdr_.size() &&
+           rdr_.size() >= np_->get_need() ) {
       size_t rlen = 0;
-      if ( np_->parse( &rdr_[idx], rsz_, rlen ) ) {
-        idx  += rlen;
-        rsz_ -= rlen;
+      np_->set_need( 0 );
+      if ( np_->parse( rdr_.data(), rdr_.size(), rlen ) ) {
+        rdr_.consume( rlen );
       } else {
-        // shuffle remaining bytes to beginning of buffer
-        if ( idx ) {
-          __builtin_memmove( &rdr_[0], &rdr_[idx], rsz_ );
-        }
         break;
       }
     }
@@ -508,8 +599,12 @@ void net_connect::teardown()
     whd_ = nxt;
   }
   wtl_ = nullptr;
-  rdr_.clear();
-  rsz_ = wsz_ = 0;
+  rdr_.reset();
+  wsz_ = 0;
+  wnum_ = 0;
+  if ( np_ ) {
+    np_->reset();
+  }
 }
 
 ///////////////////////////////////////////////////////////////////////////
@@ -806,6 +901,42 @@ void udp_socket::send( ip_addr *ap, const char *buf, size_t len )
       saddr, sizeof( sockaddr_in ) );
 }
 
+unsigned udp_socket::send( ip_addr *ap, const iovec *iov, unsigned num )
+{
+  mmsghdr msg[max_batch];
+  unsigned sent = 0;
+  while( sent != num ) {
+    unsigned cnt = num - sent;
+    cnt = cnt < max_batch ? cnt : max_batch;
+    for( unsigned i=0; i != cnt; ++i ) {
+      msghdr *hptr = &msg[i].msg_hdr;
+      __builtin_memset( hptr, 0, sizeof( msghdr ) );
+      hptr->msg_name    = ap->buf_;
+      hptr->msg_namelen = sizeof( sockaddr_in );
+      hptr->msg_iov     = (iovec*)&iov[sent+i];
+      hptr->msg_iovlen  = 1;
+    }
+    int rc = ::sendmmsg( get_fd(), msg, cnt, MSG_NOSIGNAL );
+    if ( rc <= 0 ) {
+      break;
+    }
+    sent += rc;
+  }
+  return sent;
+}
+
+bool udp_socket::set_mcast( int ttl, bool loop )
+{
+  unsigned char cttl = (unsigned char)ttl, cloop = loop ? 1 : 0;
+  if ( 0 != ::setsockopt(
+        get_fd(), IPPROTO_IP, IP_MULTICAST_TTL, &cttl, sizeof( cttl ) ) ||
+       0 != ::setsockopt(
+        get_fd(), IPPROTO_IP, IP_MULTICAST_LOOP, &cloop, sizeof( cloop ) ) ){
+    return set_err_msg( "failed to set multicast options", errno );
+  }
+  return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////
 // http_request
 
@@ -916,7 +1047,11 @@ bool http_client::parse( const char *ptr, size_t len, size_t& res )
   // parse body
   ptr += 2;
   const char *cnt = &ptr[clen];
-  if ( cnt > end ) return false;
+  if ( cnt > end ) {
+    // wait for rest of body before re-parsing headers
+    set_need( cnt - beg );
+    return false;
+  }
 
   parse_content( ptr, clen );
   // assign total message size
@@ -1037,7 +1172,11 @@ bool http_server::parse( const char *ptr, size_t len, size_t& res )
   // parse body
   ptr += 2;
   const char *cnt = &ptr[clen];
-  if ( cnt > end ) return false;
+  if ( cnt > end ) {
+    // wait for rest of body before re-parsing headers
+    set_need( cnt - beg );
+    return false;
+  }
 
   // assign total message size
   res = cnt - beg;
@@ -1077,6 +1216,21 @@ void http_server::upgrade_ws()
   msg.add_hdr( "Connection", "Upgrade" );
   msg.add_hdr( "Upgrade", "websocket" );
   msg.add_hdr( "Sec-WebSocket-Accept", str( bkey, blen ) );
+
+  // select first offered subprotocol accepted by websocket parser
+  str prot;
+  if ( get_header_val( "Sec-WebSocket-Protocol", prot ) ) {
+    const char *ptr = prot.str_, *end = &prot.str_[prot.len_];
+    while( ptr != end ) {
+      for( ; ptr != end && ( *ptr == ',' || isspace(*ptr) ); ++ptr );
+      const char *tok = ptr;
+      for( ; ptr != end && *ptr != ',' && !isspace(*ptr); ++ptr );
+      if ( ptr != tok && wp_->accept_protocol( str( tok, ptr - tok ) ) ) {
+        msg.add_hdr( "Sec-WebSocket-Protocol", str( tok, ptr - tok ) );
+        break;
+      }
+    }
+  }
   msg.commit();
   np_->add_send( msg );
 
@@ -1267,12 +1421,11 @@ void ws_wtr::commit( uint8_t op_code, net_wtr& buf, bool mask )
     hdsz += sizeof( uint32_t );
     advance( hdsz );
     add( buf );
-    unsigned i=0;
+    size_t i=0;
     for( net_buf *ptr = hd_; ptr; ptr = ptr->next_ ) {
-      for( char *ibuf = &ptr->buf_[hdsz], *ebuf = &ptr->buf_[ptr->size_];
-           ibuf != ebuf; ++ibuf, ++i ) {
-        *ibuf ^= mptr[i%4];
-      }
+      size_t len = ptr->size_ - hdsz;
+      apply_mask( &ptr->buf_[hdsz], len, mptr, i );
+      i += len;
       hdsz = 0;
     }
   } else {
@@ -1281,11 +1434,45 @@ void ws_wtr::commit( uint8_t op_code, net_wtr& buf, bool mask )
   }
 }
 
+void ws_wtr::apply_mask(
+    char *buf, size_t len, const char *mask, size_t pos )
+{
+  // mask rotated to payload offset and widened to 8 bytes
+  uint8_t mbuf[8];
+  for( unsigned i=0; i != 8; ++i ) {
+    mbuf[i] = mask[(pos+i)%4];
+  }
+  uint64_t m8;
+  __builtin_memcpy( &m8, mbuf, sizeof( m8 ) );
+
+  // 32 bytes per iteration so compiler can use vector registers
+  char *end = &buf[len];
+  for( ; end - buf >= 32; buf += 32 ) {
+    uint64_t v[4];
+    __builtin_memcpy( v, buf, sizeof( v ) );
+    v[0] ^= m8;
+    v[1] ^= m8;
+    v[2] ^= m8;
+    v[3] ^= m8;
+    __builtin_memcpy( buf, v, sizeof( v ) );
+  }
+  for( ; end - buf >= 8; buf += 8 ) {
+    uint64_t v;
+    __builtin_memcpy( &v, buf, sizeof( v ) );
+    v ^= m8;
+    __builtin_memcpy( buf, &v, sizeof( v ) );
+  }
+  for( unsigned i=0; buf != end; ++buf, ++i ) {
+    *buf ^= mbuf[i];
+  }
+}
+
 ///////////////////////////////////////////////////////////////////////////
 // ws_parser
 
 ws_parser::ws_parser()
-: wptr_( nullptr )
+: wptr_( nullptr ),
+  is_bin_( false )
 {
 }
 
@@ -1294,11 +1481,28 @@ void ws_parser::set_net_connect( net_connect *wptr )
   wptr_ = wptr;
 }
 
+void ws_parser::reset()
+{
+  net_parser::reset();
+  msg_.clear();
+  is_bin_ = false;
+}
+
 net_connect *ws_parser::get_net_connect() const
 {
   return wptr_;
 }
 
+void ws_parser::add_frag( const char *payload, size_t pay_len )
+{
+  size_t sz = msg_.size() + pay_len;
+  if ( sz > msg_.capacity() ) {
+    size_t cap = std::max( 2*msg_.capacity(), sz );
+    msg_.reserve( cap > msg_len ? cap : msg_len );
+  }
+  msg_.insert( msg_.end(), payload, &payload[pay_len] );
+}
+
 bool ws_parser::parse( const char *ptr, size_t len, size_t& res )
 {
   if ( len < sizeof( ws_hdr1 ) ) return false;
@@ -1308,43 +1512,61 @@ bool ws_parser::parse( const char *ptr, size_t len, size_t& res )
   if ( hptr1->pay_len1_ < 126 ) {
     pay_len = hptr1->pay_len1_;
     payload += sizeof( ws_hdr1 );
-    if ( len < sizeof( ws_hdr1 ) + pay_len + msk_len ) return false;
+    if ( len < sizeof( ws_hdr1 ) + pay_len + msk_len ) {
+      set_need( sizeof( ws_hdr1 ) + pay_len + msk_len );
+      return false;
+    }
   } else if ( hptr1->pay_len1_ == 126 ) {
     if ( len < sizeof( ws_hdr2) ) return false;
     ws_hdr2 *hptr2 = (ws_hdr2*)ptr;
     payload += sizeof( ws_hdr2 );
     pay_len = __builtin_bswap16( hptr2->pay_len2_);
-    if ( len < sizeof( ws_hdr2 ) + pay_len + msk_len ) return false;
+    if ( len < sizeof( ws_hdr2 ) + pay_len + msk_len ) {
+      set_need( sizeof( ws_hdr2 ) + pay_len + msk_len );
+      return false;
+    }
   } else {
     if ( len < sizeof( ws_hdr3) ) return false;
     ws_hdr3 *hptr3 = (ws_hdr3*)ptr;
     payload += sizeof( ws_hdr3 );
     pay_len = __builtin_bswap64( hptr3->pay_len3_ );
     size_t tot_sz = sizeof( ws_hdr3 ) + pay_len + msk_len;
-    if ( len < tot_sz ) return false;
+    if ( len < tot_sz ) {
+      set_need( tot_sz );
+      return false;
+    }
   }
   if ( msk_len ) {
     const char *mask = payload;
     payload += msk_len;
-    for(unsigned i=0; i != pay_len;++i ) {
-      payload[i] = payload[i] ^ mask[i%4];
-    }
+    ws_wtr::apply_mask( payload, pay_len, mask, 0 );
   }
   res = pay_len + ( payload - ptr );
   switch( hptr1->op_code_ ) {
     case ws_wtr::text_id:
     case ws_wtr::binary_id:{
+      is_bin_ = hptr1->op_code_ == ws_wtr::binary_id;
       if ( hptr1->fin_ ) {
-        parse_msg( payload, pay_len );
+        if ( is_bin_ ) {
+          parse_bin_msg( payload, pay_len );
+        } else {
+          parse_msg( payload, pay_len );
+        }
       } else {
-        msg_.insert( msg_.end(), payload, &payload[pay_len] );
+        // reassemble fragments in arena kept across messages
+        msg_.clear();
+        add_frag( payload, pay_len );
       }
       break;
     }
     case ws_wtr::cont_id:{
-      msg_.insert( msg_.end(), payload, &payload[pay_len] );
+      add_frag( payload, pay_len );
       if ( hptr1->fin_ ) {
-        parse_msg( msg_.data(), msg_.size() );
+        if ( is_bin_ ) {
+          parse_bin_msg( msg_.data(), msg_.size() );
+        } else {
+          parse_msg( msg_.data(), msg_.size() );
+        }
         msg_.clear();
       }
       break;
@@ -1380,6 +1602,16 @@ void ws_parser::parse_msg( const char *, size_t )
 {
 }
 
+void ws_parser::parse_bin_msg( const char *buf, size_t sz )
+{
+  parse_msg( buf, sz );
+}
+
+bool ws_parser::accept_protocol( str )
+{
+  return false;
+}
+
 ///////////////////////////////////////////////////////////////////////////
 // json_wtr
 
@@ -1496,6 +1728,14 @@ void json_wtr::add_key( str key, const hash& pk )
   add_enc_base58( str( pk.data(), hash::len ) );
 }
 
+void json_wtr::add_key( str key, const pub_key_b58& pk )
+{
+  add_key_only( key );
+  add( '"' );
+  add( pk.get_text() );
+  add( '"' );
+}
+
 void json_wtr::add_val( str val )
 {
   add_first();
@@ -1507,6 +1747,14 @@ void json_wtr::add_val( const hash& pk )
   add_val_enc_base58( str( pk.data(), hash::len ) );
 }
 
+void json_wtr::add_val( const pub_key_b58& pk )
+{
+  add_first();
+  add( '"' );
+  add( pk.get_text() );
+  add( '"' );
+}
+
 void json_wtr::add_val( const signature& sig )
 {
   add_val_enc_base58( str( sig.data(), signature::len ) );
@@ -1569,8 +1817,18 @@ void json_wtr::add_enc_base58( str val )
   add( '"' );
   size_t rsv_len = val.len_ + val.len_;
   char *tgt = reserve( rsv_len );
-  advance( enc_base58( (const uint8_t*)val.str_,
-        val.len_, (uint8_t*)tgt, rsv_len ) );
+  int tlen;
+  if ( val.len_ == hash::len ) {
+    tlen = enc_base58_fixed<hash::len>(
+        (const uint8_t*)val.str_, (uint8_t*)tgt, rsv_len );
+  } else if ( val.len_ == signature::len ) {
+    tlen = enc_base58_fixed<signature::len>(
+        (const uint8_t*)val.str_, (uint8_t*)tgt, rsv_len );
+  } else {
+    tlen = enc_base58( (const uint8_t*)val.str_,
+        val.len_, (uint8_t*)tgt, rsv_len );
+  }
+  advance( tlen );
   add( '"' );
 }
 
@@ -4,6 +4,7 @@
 #include <pc/key_pair.hpp>
 #include <pc/misc.hpp>
 #include <sys/epoll.h>
+#include <sys/uio.h>
 #include <vector>
 
 namespace pc
@@ -49,10 +50,71 @@ namespace pc
   class net_parser : public error
   {
   public:
+    net_parser();
     virtual ~net_parser();
 
     // parse inbound message
     virtual bool parse( const char *buf, size_t sz, size_t& len ) = 0;
+
+    // total bytes required by incomplete message if known (or zero)
+    // parse is not re-attempted until this many bytes are buffered
+    void set_need( size_t );
+    size_t get_need() const;
+
+    // drop state of any partially parsed message on new connection
+    virtual void reset();
+
+  private:
+    size_t need_;
+  };
+
+  // adaptive inbound read buffer. grows geometrically to fit the
+  // message being parsed and only moves unparsed bytes to the front
+  // when more space is required
+  class net_rbuf
+  {
+  public:
+    net_rbuf();
+    ~net_rbuf();
+
+    // unparsed bytes
+    char *data();
+    size_t size() const;
+
+    // get free space for next read of at least len bytes
+    char *reserve( size_t len, size_t& avail );
+
+    // add bytes read into reserved space
+    void advance( size_t len );
+
+    // drop parsed bytes from front
+    void consume( size_t len );
+
+    // release buffer
+    void reset();
+
+    // statistics
+    uint64_t get_num_recv() const;    // number of reads
+    uint64_t get_recv_bytes() const;  // total bytes read
+    uint64_t get_max_recv() const;    // largest single read
+    uint64_t get_move_bytes() const;  // bytes moved or copied
+    uint64_t get_num_realloc() const; // number of buffer allocations
+    size_t   get_capacity() const;    // current buffer size
+
+  private:
+    static const size_t min_len  = 16384;
+    static const size_t min_free = 2048;
+    static const size_t max_idle = 262144;
+
+    char    *buf_;
+    size_t   cap_;
+    size_t   beg_;
+    size_t   end_;
+    uint64_t nrecv_;
+    uint64_t rbytes_;
+    uint64_t mrecv_;
+    uint64_t mbytes_;
+    uint64_t nalloc_;
   };
 
   class net_socket;
@@ -145,20 +207,26 @@ namespace pc
     // any messages in the send queue
     bool get_is_send() const;
 
+    // bytes in the send queue and most bytes ever queued
+    size_t get_send_size() const;
+    size_t get_max_send_size() const;
+
+    // inbound read buffer and its statistics
+    const net_rbuf& get_read_buf() const;
+
     // drop all outbound messages
     void teardown() override;
 
   protected:
 
-    typedef std::vector<char> buf_t;
-    static const size_t buf_len = 2048;
     void poll_error( bool );
 
-    buf_t       rdr_; // inbound message read buffer
+    net_rbuf    rdr_; // inbound message read buffer
     net_buf    *whd_; // head of writer queue
     net_buf    *wtl_; // tail of writer queue
-    size_t      rsz_; // current read position
     uint16_t    wsz_; // current write position
+    size_t      wnum_;// bytes in writer queue
+    size_t      wmax_;// max bytes in writer queue
     net_parser *np_;  // message parser
   };
 
@@ -266,8 +334,17 @@ namespace pc
   class udp_socket : public net_socket
   {
   public:
+    static const unsigned max_batch = 64;
+
     bool init() override;
     void send( ip_addr *, const char *buf, size_t len );
+
+    // send datagrams to one address with one sendmmsg call per
+    // max_batch datagrams. returns number of datagrams sent
+    unsigned send( ip_addr *, const iovec *, unsigned num );
+
+    // multicast time-to-live and loopback to local receivers
+    bool set_mcast( int ttl, bool loop );
   };
 
   // http request message
@@ -353,6 +430,10 @@ namespace pc
     static const uint8_t pong_id   = 0xa;
 
     void commit( uint8_t opcode, net_wtr&, bool mask );
+
+    // xor payload bytes with 4-byte mask starting at payload offset pos
+    static void apply_mask( char *buf, size_t len,
+                            const char *mask, size_t pos );
   };
 
   class tx_sub
@@ -414,10 +495,24 @@ namespace pc
     // callback on websocket message
     virtual void parse_msg( const char *buf, size_t sz );
 
+    // callback on binary websocket message (defaults to parse_msg)
+    virtual void parse_bin_msg( const char *buf, size_t sz );
+
+    // accept subprotocol offered on connection upgrade
+    virtual bool accept_protocol( str );
+
+    // drop partially reassembled message
+    void reset() override;
+
   protected:
+    // append fragment to reassembly buffer
+    void add_frag( const char *, size_t );
+
     typedef std::vector<char> buf_t;
+    static const size_t msg_len = 16384;
     buf_t        msg_;
     net_connect *wptr_;
+    bool         is_bin_; // fragmented message is binary
   };
 
   class json_wtr : public net_wtr
@@ -442,6 +537,7 @@ namespace pc
     void add_key( str key, uint64_t val );
     void add_key( str key, type_t );
     void add_key( str key, const hash& );
+    void add_key( str key, const pub_key_b58& );
     void add_key( str key, null );
     void add_key( str key, jtrue );
     void add_key( str key, jfalse );
@@ -454,6 +550,7 @@ namespace pc
     void add_val( type_t );
     void add_val( const key_pair& );
     void add_val( const hash& );
+    void add_val( const pub_key_b58& );
     void add_val( const signature& );
     void add_val_enc_base58( str val );
     void add_val_enc_base64( str val );
@@ -509,4 +606,67 @@ namespace pc
     val = path_;
   }
 
+  inline void net_parser::set_need( size_t need )
+  {
+    need_ = need;
+  }
+
+  inline size_t net_parser::get_need() const
+  {
+    return need_;
+  }
+
+  inline char *net_rbuf::data()
+  {
+    return &buf_[beg_];
+  }
+
+  inline size_t net_rbuf::size() const
+  {
+    return end_ - beg_;
+  }
+
+  inline void net_rbuf::advance( size_t len )
+  {
+    end_ += len;
+    rbytes_ += len;
+    ++nrecv_;
+    mrecv_ = len > mrecv_ ? len : mrecv_;
+  }
+
+  inline uint64_t net_rbuf::get_num_recv() const
+  {
+    return nrecv_;
+  }
+
+  inline uint64_t net_rbuf::get_recv_bytes() const
+  {
+    return rbytes_;
+  }
+
+  inline uint64_t net_rbuf::get_max_recv() const
+  {
+    return mrecv_;
+  }
+
+  inline uint64_t net_rbuf::get_move_bytes() const
+  {
+    return mbytes_;
+  }
+
+  inline uint64_t net_rbuf::get_num_realloc() const
+  {
+    return nalloc_;
+  }
+
+  inline size_t net_rbuf::get_capacity() const
+  {
+    return cap_;
+  }
+
+  inline const net_rbuf& net_connect::get_read_buf() const
+  {
+    return rdr_;
+  }
+
 }
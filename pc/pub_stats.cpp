@@ -10,7 +10,7 @@ pub_stats::pub_stats()
 
 void pub_stats::clear_stats()
 {
-  num_agg_ = num_sent_ = num_recv_ = num_sub_drop_ =
+  num_agg_ = num_sent_ = num_coal_ = num_recv_ = num_sub_drop_ =
     agg_slot_ = pub_slot_ = 0UL;
   __builtin_memset( shist_, 0, sizeof( shist_ ) );
 }
@@ -25,6 +25,11 @@ uint64_t pub_stats::get_num_sent() const
   return num_sent_;
 }
 
+uint64_t pub_stats::get_num_coalesce() const
+{
+  return num_coal_;
+}
+
 uint64_t pub_stats::get_num_recv() const
 {
   return num_recv_;
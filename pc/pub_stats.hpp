@@ -15,6 +15,9 @@ namespace pc
     // number of prices submited
     uint64_t get_num_sent() const;
 
+    // number of prices replaced by a newer price before being sent
+    uint64_t get_num_coalesce() const;
+
     // number of observed aggregate slot updates
     uint64_t get_num_agg() const;
 
@@ -46,11 +49,15 @@ namespace pc
     // increment number of prices sent
     void inc_sent();
 
+    // increment number of prices replaced before being sent
+    void inc_coalesce();
+
   private:
 
     static constexpr const uint64_t num_buckets = 32;
 
     uint64_t num_sent_;
+    uint64_t num_coal_;
     uint64_t num_recv_;
     uint64_t num_agg_;
     uint64_t num_sub_drop_;
@@ -69,4 +76,9 @@ namespace pc
     ++num_sent_;
   }
 
+  inline void pub_stats::inc_coalesce()
+  {
+    ++num_coal_;
+  }
+
 }
@@ -1,6 +1,7 @@
 #include "request.hpp"
 #include "manager.hpp"
 #include "mem_map.hpp"
+#include "snapshot.hpp"
 #include "log.hpp"
 #include <algorithm>
 #include <math.h>
@@ -81,7 +82,8 @@ request::request()
   clnt_( nullptr ),
   cb_( nullptr ),
   is_submit_( false ),
-  is_recv_( false )
+  is_recv_( false ),
+  rslot_( 0UL )
 {
 }
 
@@ -151,6 +153,33 @@ bool request::get_is_recv() const
   return is_recv_;
 }
 
+void request::set_recv_slot( uint64_t slot )
+{
+  rslot_ = slot;
+}
+
+uint64_t request::get_recv_slot() const
+{
+  return rslot_;
+}
+
+void request::refresh()
+{
+}
+
+bool request::resync( uint64_t slot )
+{
+  if ( get_recv_slot() < slot ) {
+    refresh();
+    return true;
+  }
+  return false;
+}
+
+void request::on_snapshot( snapshot * )
+{
+}
+
 void request::on_response( rpc::program_subscribe * )
 {
 }
@@ -281,7 +310,7 @@ void get_mapping::set_mapping_key( const pub_key& mkey )
   mkey_ = mkey;
 }
 
-pub_key *get_mapping::get_mapping_key()
+pub_key_b58 *get_mapping::get_mapping_key()
 {
   return &mkey_;
 }
@@ -296,6 +325,11 @@ bool get_mapping::get_is_full() const
   return num_sym_ >= PC_MAP_TABLE_SIZE;
 }
 
+const pc_acc_t *get_mapping::get_image() const
+{
+  return img_.empty() ? nullptr : (const pc_acc_t*)img_.c_str();
+}
+
 void get_mapping::reset()
 {
   reset_err();
@@ -313,15 +347,35 @@ void get_mapping::submit()
   get_rpc_client()->send( areq_ );
 }
 
+void get_mapping::refresh()
+{
+  areq_->set_commitment( get_manager()->get_commitment() );
+  get_rpc_client()->send( areq_ );
+}
+
+void get_mapping::on_snapshot( snapshot *res )
+{
+  set_is_recv( true );
+  set_recv_slot( res->get_slot() );
+  update( res );
+}
+
 void get_mapping::on_response( rpc::get_account_info *res )
 {
+  // ignore refetched state older than latest subscription update
+  if ( get_is_recv() && !res->get_is_err() &&
+       res->get_slot() < get_recv_slot() ) {
+    return;
+  }
   set_is_recv( true );
+  set_recv_slot( res->get_slot() );
   update( res );
 }
 
 void get_mapping::on_response( rpc::program_subscribe *res )
 {
   if ( get_is_recv( )) {
+    set_recv_slot( res->get_slot() );
     update( res );
   }
 }
@@ -346,6 +400,10 @@ void get_mapping::update( T *res )
         std::to_string( tab->ver_ ) );
   }
 
+  // keep populated region of account for warm-start snapshot
+  img_.assign( (const char*)tab,
+      std::min( (size_t)tab->size_, sizeof( pc_map_table_t ) ) );
+
   // check and get any new product accounts in mapping table
   num_sym_ = tab->num_;
   PC_LOG_INF( "add_mapping" )
@@ -1669,7 +1727,7 @@ product::~product()
   pvec_.clear();
 }
 
-pub_key *product::get_account()
+pub_key_b58 *product::get_account()
 {
   return &acc_;
 }
@@ -1701,15 +1759,35 @@ void product::submit()
   cptr->send( areq_ );
 }
 
+void product::refresh()
+{
+  areq_->set_commitment( get_manager()->get_commitment() );
+  get_rpc_client()->send( areq_ );
+}
+
+void product::on_snapshot( snapshot *res )
+{
+  set_is_recv( true );
+  set_recv_slot( res->get_slot() );
+  update( res );
+}
+
 void product::on_response( rpc::get_account_info *res )
 {
+  // ignore refetched state older than latest subscription update
+  if ( get_is_recv() && !res->get_is_err() &&
+       res->get_slot() < get_recv_slot() ) {
+    return;
+  }
   set_is_recv( true );
+  set_recv_slot( res->get_slot() );
   update( res );
 }
 
 void product::on_response( rpc::program_subscribe *res )
 {
   if ( get_is_recv() ) {
+    set_recv_slot( res->get_slot() );
     update( res );
   }
 }
@@ -1740,6 +1818,9 @@ void product::update( T *res )
     return;
   }
 
+  // keep account for warm-start snapshot
+  img_.assign( (const char*)prod, std::min( (size_t)prod->size_, plen ) );
+
   // subscribe to firstprice account in chain
   if ( !pc_pub_key_is_zero( &prod->px_acc_ ) ) {
     cptr->add_price( *(pub_key*)&prod->px_acc_, this );
@@ -1760,6 +1841,7 @@ void product::update( T *res )
 
   // capture product attributes to disk
   cptr->write( (pc_pub_key_t*)acc_.data(), (pc_acc_t*)prod );
+  cptr->inval_product_list();
 
   if ( st_ != e_done ) {
     // log new product
@@ -1777,6 +1859,11 @@ bool product::get_is_done() const
   return st_ == e_done;
 }
 
+const pc_acc_t *product::get_image() const
+{
+  return img_.empty() ? nullptr : (const pc_acc_t*)img_.c_str();
+}
+
 unsigned product::get_num_price() const
 {
   return pvec_.size();
@@ -1805,6 +1892,7 @@ price::price( const pub_key& acc, product *prod )
   isched_( false ),
   st_( e_subscribe ),
   pub_idx_( (unsigned)-1 ),
+  hdl_( (uint32_t)-1 ),
   apub_( acc ),
   lamports_( 0UL ),
   pub_slot_( 0UL ),
@@ -1864,7 +1952,7 @@ bool price::get_attr( attr_id aid, str& val ) const
   return prod_->get_attr( aid, val );
 }
 
-pub_key *price::get_account()
+pub_key_b58 *price::get_account()
 {
   return &apub_;
 }
@@ -1944,9 +2032,29 @@ uint64_t price::get_pub_slot() const
   return pptr_->agg_.pub_slot_;
 }
 
+uint32_t price::get_handle() const
+{
+  return hdl_;
+}
+
+const pc_acc_t *price::get_image() const
+{
+  if ( pptr_->magic_ != PC_MAGIC || pptr_->size_ > sizeof( pc_price_t ) ) {
+    return nullptr;
+  }
+  return (const pc_acc_t*)pptr_;
+}
+
+void price::set_handle( uint32_t hdl )
+{
+  hdl_ = hdl;
+}
+
 bool price::get_is_ready_publish() const
 {
-  return st_ == e_publish && get_manager()->get_is_tx_connect();
+  manager *mgr = get_manager();
+  return st_ == e_publish && mgr->get_is_tx_connect() &&
+    mgr->has_status( PC_PYTH_RPC_CONNECTED | PC_PYTH_HAS_BLOCK_HASH );
 }
 
 void price::reset()
@@ -2005,11 +2113,16 @@ bool price::update(
   if ( PC_UNLIKELY( !get_is_ready_publish() ) ) {
     return false;
   }
+  // a pending update is replaced in place and sent once
   manager *mgr = get_manager();
+  if ( preq_->get_is_pending() ) {
+    inc_coalesce();
+  } else {
+    inc_sent();
+  }
   preq_->set_price( price, conf, st, mgr->get_slot(), is_agg );
   preq_->set_block_hash( mgr->get_recent_block_hash() );
   mgr->submit( preq_ );
-  inc_sent();
   return true;
 }
 
@@ -2024,15 +2137,39 @@ void price::submit()
   }
 }
 
+void price::refresh()
+{
+  areq_->set_commitment( get_manager()->get_commitment() );
+  get_rpc_client()->send( areq_ );
+}
+
+void price::on_snapshot( snapshot *res )
+{
+  // complete subscription as if account info had been requested
+  if ( st_ == e_subscribe ) {
+    st_ = e_sent_subscribe;
+  }
+  set_is_recv( true );
+  set_recv_slot( res->get_slot() );
+  update( res );
+}
+
 void price::on_response( rpc::get_account_info *res )
 {
+  // ignore refetched state older than latest subscription update
+  if ( get_is_recv() && !res->get_is_err() &&
+       res->get_slot() < get_recv_slot() ) {
+    return;
+  }
   set_is_recv( true );
+  set_recv_slot( res->get_slot() );
   update( res );
 }
 
 void price::on_response( rpc::program_subscribe *res )
 {
   if ( get_is_recv() ) {
+    set_recv_slot( res->get_slot() );
     update( res );
   }
 }
@@ -2071,6 +2208,7 @@ void price::init_subscribe()
 
   // log new price object
   log_update( "add_price" );
+  mgr->inval_product_list();
 
   // callback users on new symbol update
   manager_sub *sub = mgr->get_manager_sub();
@@ -2104,6 +2242,7 @@ void price::update( T *res )
 
   // price account was (re) initialized
   if ( PC_UNLIKELY( pptr_->agg_.pub_slot_ == 0L ) ) {
+    get_manager()->inval_product_list();
     log_update( "init_price" );
     on_response_sub( &pinit_ );
   }
@@ -2129,6 +2268,9 @@ void price::update( T *res )
     // capture aggregate price and components to disk
     mgr->write( (pc_pub_key_t*)apub_.data(), (pc_acc_t*)pptr_ );
 
+    // publish aggregate price to shared-memory feed
+    mgr->write( this );
+
     // add slot/time latency statistics
     if ( pub_idx_ != (unsigned)-1 ) {
       uint64_t pub_slot = pptr_->comp_[pub_idx_].agg_.pub_slot_;
@@ -12,6 +12,7 @@ namespace pc
   class request;
   class product;
   class price;
+  class snapshot;
 
   // pyth request subscriber
   class request_sub
@@ -99,6 +100,20 @@ namespace pc
     // has received account update
     void set_is_recv( bool );
     bool get_is_recv() const;
+
+    // slot of latest account update received
+    void set_recv_slot( uint64_t );
+    uint64_t get_recv_slot() const;
+
+    // refetch account state without resetting subscription state
+    virtual void refresh();
+
+    // refresh if no account update received since slot (true if sent)
+    bool resync( uint64_t slot );
+
+    // initialize from account image of warm-start snapshot
+    virtual void on_snapshot( snapshot * );
+
     void on_response( rpc::program_subscribe * ) override;
 
   protected:
@@ -117,6 +132,7 @@ namespace pc
     node_list_t slist_;
     bool        is_submit_;
     bool        is_recv_;
+    uint64_t    rslot_;
   };
 
   // create initial mapping acount
@@ -157,13 +173,18 @@ namespace pc
   public:
     get_mapping();
     void set_mapping_key( const pub_key& );
-    pub_key *get_mapping_key();
+    pub_key_b58 *get_mapping_key();
     uint32_t get_num_symbols() const;
     bool     get_is_full() const;
 
+    // latest mapping account image (or nullptr)
+    const pc_acc_t *get_image() const;
+
   public:
     void reset();
     void submit() override;
+    void refresh() override;
+    void on_snapshot( snapshot * ) override;
     void on_response( rpc::get_account_info * ) override;
     void on_response( rpc::program_subscribe * ) override;
   private:
@@ -171,9 +192,10 @@ namespace pc
 
     template<class T> void update( T* );
 
-    state_t  st_;
-    pub_key  mkey_;
-    uint32_t num_sym_;
+    state_t     st_;
+    pub_key_b58 mkey_;
+    uint32_t    num_sym_;
+    std::string img_;
     rpc::get_account_info areq_[1];
   };
 
@@ -569,7 +591,7 @@ namespace pc
   {
   public:
     // product account number
-    pub_key *get_account();
+    pub_key_b58 *get_account();
 
     // symbol from attr_dict
     str get_symbol();
@@ -580,12 +602,17 @@ namespace pc
     price *get_price( unsigned i ) const;
     price *get_price( price_type ) const;
 
+    // latest product account image (or nullptr)
+    const pc_acc_t *get_image() const;
+
   public:
 
     product( const pub_key& );
     virtual ~product();
     void reset();
     void submit() override;
+    void refresh() override;
+    void on_snapshot( snapshot * ) override;
     void on_response( rpc::get_account_info * ) override;
     void on_response( rpc::program_subscribe * ) override;
     bool get_is_done() const override;
@@ -597,9 +624,10 @@ namespace pc
 
     template<class T> void update( T *res );
 
-    pub_key                acc_;
+    pub_key_b58            acc_;
     prices_t               pvec_;
     state_t                st_;
+    std::string            img_;
     rpc::get_account_info  areq_[1];
   };
 
@@ -680,7 +708,7 @@ namespace pc
     price_sched *get_sched();
 
     // various accessors
-    pub_key      *get_account();
+    pub_key_b58  *get_account();
     price_type    get_price_type() const;
     int64_t       get_price_exponent() const;
     uint32_t      get_version() const;
@@ -710,6 +738,12 @@ namespace pc
     // slot of last aggregate price
     uint64_t      get_pub_slot() const;
 
+    // index of price in manager price table
+    uint32_t      get_handle() const;
+
+    // latest price account image (or nullptr)
+    const pc_acc_t *get_image() const;
+
   public:
 
     void set_price_type( price_type );
@@ -718,10 +752,13 @@ namespace pc
     void set_conf( int64_t );
     void set_symbol_status( symbol_status );
     void set_product( product * );
+    void set_handle( uint32_t );
 
     void reset();
     void unsubscribe();
     void submit() override;
+    void refresh() override;
+    void on_snapshot( snapshot * ) override;
     void on_response( rpc::get_account_info * ) override;
     void on_response( rpc::program_subscribe * ) override;
     bool get_is_done() const override;
@@ -743,7 +780,8 @@ namespace pc
     bool                   isched_;
     state_t                st_;
     uint32_t               pub_idx_;
-    pub_key                apub_;
+    uint32_t               hdl_;
+    pub_key_b58            apub_;
     uint64_t               lamports_;
     uint64_t               pub_slot_;
     product               *prod_;
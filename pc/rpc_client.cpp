@@ -122,12 +122,11 @@ static void send_transaction( json_wtr& msg, bincode& tx )
 // rpc_client
 
 rpc_client::rpc_client()
-: hptr_( nullptr ),
-  wptr_( nullptr ),
+: wptr_( nullptr ),
   id_( 0UL ),
+  lts_( 0L ),
   cxt_( nullptr )
 {
-  hp_.cp_ = this;
   wp_.cp_ = this;
   cxt_ = ZSTD_createDCtx();
 }
@@ -138,17 +137,62 @@ rpc_client::~rpc_client()
     ZSTD_freeDCtx( (ZSTD_DCtx*)cxt_ );
     cxt_ = nullptr;
   }
+  for( rpc_http *hp: hvec_ ) {
+    delete hp;
+  }
+  hvec_.clear();
 }
 
 void rpc_client::set_http_conn( net_connect *hptr )
 {
-  hptr_ = hptr;
-  hptr_->set_net_parser( &hp_ );
+  if ( hvec_.empty() ) {
+    add_http_conn( hptr );
+  } else {
+    hvec_[0]->hptr_ = hptr;
+    hptr->set_net_parser( hvec_[0] );
+  }
 }
 
 net_connect *rpc_client::get_http_conn() const
 {
-  return hptr_;
+  return hvec_.empty() ? nullptr : hvec_[0]->hptr_;
+}
+
+void rpc_client::add_http_conn( net_connect *hptr )
+{
+  rpc_http *hp = new rpc_http;
+  hp->cp_   = this;
+  hp->hptr_ = hptr;
+  hp->nout_ = 0;
+  hp->nreq_ = 0UL;
+  hp->lat_  = 0L;
+  hptr->set_net_parser( hp );
+  hvec_.push_back( hp );
+}
+
+unsigned rpc_client::get_num_http_conn() const
+{
+  return hvec_.size();
+}
+
+net_connect *rpc_client::get_http_conn( unsigned i ) const
+{
+  return hvec_[i]->hptr_;
+}
+
+uint32_t rpc_client::get_http_outstanding( unsigned i ) const
+{
+  return hvec_[i]->nout_;
+}
+
+uint64_t rpc_client::get_http_num_req( unsigned i ) const
+{
+  return hvec_[i]->nreq_;
+}
+
+int64_t rpc_client::get_http_latency( unsigned i ) const
+{
+  return hvec_[i]->lat_;
 }
 
 void rpc_client::set_ws_conn( net_connect *wptr )
@@ -169,6 +213,9 @@ void rpc_client::reset()
   smap_.clear();
   reuse_.clear();
   id_ = 0;
+  for( rpc_http *hp: hvec_ ) {
+    hp->nout_ = 0;
+  }
 }
 
 void rpc_client::send( rpc_request *rptr )
@@ -201,7 +248,18 @@ void rpc_client::send( rpc_request *rptr )
     msg.init( "POST", "/" );
     msg.add_hdr( "Content-Type", "application/json" );
     msg.commit( jw );
-    hptr_->add_send( msg );
+
+    // route to healthy pool member with fewest outstanding requests
+    rpc_http *hp = hvec_[0];
+    for( rpc_http *ip: hvec_ ) {
+      if ( !ip->hptr_->get_is_err() &&
+           ( ip->nout_ < hp->nout_ || hp->hptr_->get_is_err() ) ) {
+        hp = ip;
+      }
+    }
+    ++hp->nout_;
+    ++hp->nreq_;
+    hp->hptr_->add_send( msg );
   } else {
     // submit websocket message
     ws_wtr msg;
@@ -212,7 +270,15 @@ void rpc_client::send( rpc_request *rptr )
 
 void rpc_client::rpc_http::parse_content( const char *txt, size_t len )
 {
+  if ( nout_ ) {
+    --nout_;
+  }
+  cp_->lts_ = 0L;
   cp_->parse_response( txt, len );
+  if ( cp_->lts_ ) {
+    int64_t dt = get_now() - cp_->lts_;
+    lat_ = lat_ ? lat_ + ( dt - lat_ ) / 8 : dt;
+  }
 }
 
 void rpc_client::rpc_ws::parse_msg( const char *txt, size_t len )
@@ -233,6 +299,7 @@ void rpc_client::parse_response( const char *txt, size_t len )
       if ( rptr ) {
         rv_[id] = nullptr;
         reuse_.push_back( id );
+        lts_ = rptr->get_sent_time();
         rptr->response( jp_ );
       }
     }
@@ -657,6 +724,11 @@ void rpc::get_slot_leaders::set_limit( uint64_t limit )
   limit_ = limit;
 }
 
+uint64_t rpc::get_slot_leaders::get_first_slot() const
+{
+  return lslot_;
+}
+
 uint64_t rpc::get_slot_leaders::get_last_slot() const
 {
   return lslot_ + limit_;
@@ -2124,7 +2196,7 @@ void rpc::get_block::set_commitment( commitment cmt )
 
 void rpc::get_block::set_program( pub_key *gkey )
 {
-  gkey_ = gkey;
+  gkey_ = *gkey;
 }
 
 void rpc::get_block::request( json_wtr& msg )
@@ -2140,6 +2212,11 @@ void rpc::get_block::request( json_wtr& msg )
   msg.pop();
 }
 
+uint64_t rpc::get_block::get_slot() const
+{
+  return bslot_;
+}
+
 unsigned rpc::get_block::get_num_key() const
 {
   return kvec_.size();
@@ -2150,6 +2227,16 @@ pub_key *rpc::get_block::get_key( unsigned i )
   return &kvec_[i];
 }
 
+unsigned rpc::get_block::get_num_ins_key() const
+{
+  return avec_.size();
+}
+
+pub_key *rpc::get_block::get_ins_key( unsigned i )
+{
+  return &kvec_[avec_[i]];
+}
+
 char *rpc::get_block::get_cmd()
 {
   return &ibuf_[0];
@@ -2184,19 +2271,24 @@ void rpc::get_block::response( const jtree& jt )
   for( uint32_t it = jt.get_first( ttok ); it; it = jt.get_next( it ) ) {
     uint32_t tx = jt.find_val( it, "transaction" );
     uint32_t ms = jt.find_val( tx, "message" );
-    // determine if this is a pyth transaction
+    // determine if this is a pyth transaction by comparing base58 text
+    // of program id before decoding any account keys
     uint32_t ak = jt.find_val( ms, "accountKeys" );
+    str gtxt = gkey_.get_text();
     bool found = false;
+    for( uint32_t at = jt.get_first( ak ); at; at = jt.get_next( at ) ) {
+      if ( jt.get_str( at ) == gtxt ) {
+        found = true;
+        break;
+      }
+    }
+    if ( !found ) continue;
     pub_key ikey;
     kvec_.clear();
     for( uint32_t at = jt.get_first( ak ); at; at = jt.get_next( at ) ) {
       ikey.init_from_text( jt.get_str( at ) );
       kvec_.push_back( ikey );
-      if ( ikey == *gkey_ ) {
-        found = true;
-      }
     }
-    if ( !found ) continue;
     // get meta-data
     is_tx_err_ = false;
     fee_ = 0UL;
@@ -2209,13 +2301,25 @@ void rpc::get_block::response( const jtree& jt )
         tx_err_ = jt.get_str( jt.get_key( jt.get_first( ex ) ) );
       }
     }
-    // get transaction details
+    // get transaction details for each program instruction
     uint32_t ix = jt.find_val( ms, "instructions" );
-    str idata = jt.get_str( jt.find_val( jt.get_first( ix ), "data" ) );
-    ibuf_.resize( idata.len_ );
-    dec_base58( (const uint8_t*)idata.str_, idata.len_,
-                (uint8_t*)&ibuf_[0] );
-    on_response( this );
+    for( uint32_t in = jt.get_first( ix ); in; in = jt.get_next( in ) ) {
+      uint64_t pidx = jt.get_uint( jt.find_val( in, "programIdIndex" ) );
+      if ( pidx >= kvec_.size() || kvec_[pidx] != gkey_ ) continue;
+      avec_.clear();
+      uint32_t ax = jt.find_val( in, "accounts" );
+      for( uint32_t at = jt.get_first( ax ); at; at = jt.get_next( at ) ) {
+        uint64_t aidx = jt.get_uint( at );
+        if ( aidx < kvec_.size() ) {
+          avec_.push_back( aidx );
+        }
+      }
+      str idata = jt.get_str( jt.find_val( in, "data" ) );
+      ibuf_.resize( idata.len_ );
+      dec_base58( (const uint8_t*)idata.str_, idata.len_,
+                  (uint8_t*)&ibuf_[0] );
+      on_response( this );
+    }
   }
   is_end_ = true;
   on_response( this );
@@ -2235,7 +2339,10 @@ rpc::upd_price::upd_price()
   ckey_( nullptr ),
   gkey_( nullptr ),
   akey_( nullptr ),
-  cmd_( e_cmd_upd_price )
+  pub_slot_( 0UL ),
+  sent_slot_( 0UL ),
+  cmd_( e_cmd_upd_price ),
+  is_pend_( false )
 {
 }
 
@@ -2282,6 +2389,11 @@ void rpc::upd_price::set_price( int64_t px,
   cmd_   = is_agg?e_cmd_agg_price:e_cmd_upd_price;
 }
 
+bool rpc::upd_price::get_is_pending() const
+{
+  return is_pend_;
+}
+
 class tx_wtr : public net_wtr
 {
 public:
@@ -2346,3 +2458,147 @@ void rpc::upd_price::build( net_wtr& wtr )
   tx.sign( pub_idx, tx_idx, *ckey_ );
   ((tx_wtr&)wtr).commit( tx );
 }
+
+rpc::upd_prices::upd_prices()
+: num_( 0 ),
+  slot_( 0UL )
+{
+}
+
+bool rpc::upd_prices::get_is_sent( upd_price *req ) const
+{
+  uint64_t slot = req->pub_slot_ > slot_ ? req->pub_slot_ : slot_;
+  return slot <= req->sent_slot_;
+}
+
+bool rpc::upd_prices::add( upd_price *req )
+{
+  if ( req->is_pend_ ) {
+    return true;
+  }
+  if ( PC_UNLIKELY( get_is_sent( req ) ) ) {
+    req->is_pend_ = true;
+    hvec_.push_back( req );
+    return true;
+  }
+  if ( num_ == max_num ) {
+    return false;
+  }
+  req->is_pend_ = true;
+  req_[num_++] = req;
+  return true;
+}
+
+void rpc::upd_prices::set_slot( uint64_t slot )
+{
+  slot_ = slot;
+}
+
+bool rpc::upd_prices::release()
+{
+  size_t j = 0;
+  unsigned num = num_;
+  for( upd_price *req: hvec_ ) {
+    if ( num_ != max_num && !get_is_sent( req ) ) {
+      req_[num_++] = req;
+    } else {
+      hvec_[j++] = req;
+    }
+  }
+  hvec_.resize( j );
+  return num_ != num;
+}
+
+unsigned rpc::upd_prices::get_num() const
+{
+  return num_;
+}
+
+unsigned rpc::upd_prices::get_num_held() const
+{
+  return hvec_.size();
+}
+
+size_t rpc::upd_prices::get_size( unsigned num )
+{
+  return fix_size + num * price_size;
+}
+
+void rpc::upd_prices::reset()
+{
+  for( unsigned i=0; i != num_; ++i ) {
+    req_[i]->is_pend_ = false;
+  }
+  num_ = 0;
+}
+
+void rpc::upd_prices::build( net_wtr& wtr )
+{
+  // stamp prices with slot in which they are sent
+  for( unsigned i=0; i != num_; ++i ) {
+    upd_price *iptr = req_[i];
+    if ( slot_ > iptr->pub_slot_ ) {
+      iptr->pub_slot_ = slot_;
+    }
+    iptr->sent_slot_ = iptr->pub_slot_;
+  }
+
+  // single price is sent as regular upd_price transaction
+  if ( num_ == 1 ) {
+    req_[0]->build( wtr );
+    return;
+  }
+
+  // construct binary transaction and add header
+  upd_price *rptr = req_[0];
+  bincode tx;
+  ((tx_wtr&)wtr).init( tx );
+
+  // signatures section
+  tx.add_len<1>();      // one signature (publish)
+  size_t pub_idx = tx.reserve_sign();
+
+  // message header
+  size_t tx_idx = tx.get_pos();
+  tx.add( (uint8_t)1 ); // pub is only signing account
+  tx.add( (uint8_t)0 ); // read-only signed accounts
+  tx.add( (uint8_t)2 ); // sysvar and program-id are read-only
+                        // unsigned accounts
+
+  // accounts: publish, symbols, sysvar, program
+  uint8_t sys_idx = (uint8_t)( num_ + 1 );
+  uint8_t prg_idx = (uint8_t)( num_ + 2 );
+  tx.add_len( num_ + 3 );
+  tx.add( *rptr->pkey_ );
+  for( unsigned i=0; i != num_; ++i ) {
+    tx.add( *req_[i]->akey_ );
+  }
+  tx.add( *(pub_key*)sysvar_clock );
+  tx.add( *rptr->gkey_ );
+
+  // recent block hash
+  tx.add( *rptr->bhash_ );
+
+  // one instruction per symbol
+  tx.add_len( num_ );
+  for( unsigned i=0; i != num_; ++i ) {
+    upd_price *iptr = req_[i];
+    tx.add( prg_idx );      // program_id index
+    tx.add_len<3>();        // 3 accounts: publish, symbol, sysvar
+    tx.add( (uint8_t)0 );   // index of publish account
+    tx.add( (uint8_t)(i+1) ); // index of symbol account
+    tx.add( sys_idx );      // index of sysvar account
+    tx.add_len<sizeof(cmd_upd_price)>();
+    tx.add( (uint32_t)PC_VERSION );
+    tx.add( (int32_t)iptr->cmd_ );
+    tx.add( (int32_t)iptr->st_ );
+    tx.add( (int32_t)0 );
+    tx.add( iptr->price_ );
+    tx.add( iptr->conf_ );
+    tx.add( iptr->pub_slot_ );
+  }
+
+  // publish account signs for all instructions
+  tx.sign( pub_idx, tx_idx, *rptr->ckey_ );
+  ((tx_wtr&)wtr).commit( tx );
+}
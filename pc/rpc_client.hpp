@@ -19,6 +19,9 @@
 
 #define PC_TPU_PROTO_ID 0xb1ab
 
+// max size of serialized transaction (packet data size of ipv6 mtu)
+#define PC_TX_MAX_SIZE 1232
+
 namespace pc
 {
 
@@ -73,6 +76,17 @@ namespace pc
     void set_http_conn( net_connect * );
     net_connect *get_http_conn() const;
 
+    // add pooled rpc http connection. http requests are pipelined on
+    // the healthy pool member with fewest outstanding requests
+    void add_http_conn( net_connect * );
+
+    // pooled http connection statistics
+    unsigned get_num_http_conn() const;
+    net_connect *get_http_conn( unsigned ) const;
+    uint32_t get_http_outstanding( unsigned ) const; // in-flight requests
+    uint64_t get_http_num_req( unsigned ) const;     // requests sent
+    int64_t  get_http_latency( unsigned ) const;     // avg latency (ns)
+
     // rpc web socket connection
     void set_ws_conn( net_connect * );
     net_connect *get_ws_conn() const;
@@ -103,7 +117,11 @@ namespace pc
 
     struct rpc_http : public http_client {
       void parse_content( const char *, size_t ) override;
-      rpc_client *cp_;
+      rpc_client  *cp_;
+      net_connect *hptr_;   // http connection
+      uint32_t     nout_;   // outstanding requests
+      uint64_t     nreq_;   // number of requests sent
+      int64_t      lat_;    // moving average of latency
     };
 
     struct rpc_ws : public ws_parser {
@@ -122,14 +140,14 @@ namespace pc
       };
     };
 
+    typedef std::vector<rpc_http*>    http_vec_t;
     typedef std::vector<rpc_request*> request_t;
     typedef std::vector<uint64_t>     id_vec_t;
     typedef std::vector<char>         acc_buf_t;
     typedef hash_map<trait>           sub_map_t;
 
-    net_connect *hptr_;
     net_connect *wptr_;
-    rpc_http     hp_;    // http parser wrapper
+    http_vec_t   hvec_;  // http connection pool and parser wrappers
     rpc_ws       wp_;    // websocket parser wrapper
     jtree        jp_;    // json parser
     request_t    rv_;    // waiting requests by id
@@ -138,6 +156,7 @@ namespace pc
     acc_buf_t    abuf_;  // account decode buffer
     acc_buf_t    zbuf_;  // account decompress buffer
     uint64_t     id_;    // next request id
+    int64_t      lts_;   // sent time of last http response
     void        *cxt_;
   };
 
@@ -374,6 +393,7 @@ namespace pc
       void set_slot(uint64_t slot);
       void set_limit( uint64_t limit );
       pub_key *get_leader( uint64_t );
+      uint64_t get_first_slot() const;
       uint64_t get_last_slot() const;
       void request( json_wtr& ) override;
       void response( const jtree&p) override;
@@ -850,6 +870,7 @@ namespace pc
       void set_program( pub_key * );
       void request( json_wtr& ) override;
       void response( const jtree& ) override;
+      uint64_t get_slot() const;
       uint64_t get_fee() const;
       bool     get_is_tx_err() const;
       str      get_tx_err() const;
@@ -859,14 +880,21 @@ namespace pc
       char    *get_cmd();
       bool     get_is_end() const;
 
+      // accounts of current program instruction. a transaction with
+      // several program instructions is reported once per instruction
+      unsigned get_num_ins_key() const;
+      pub_key *get_ins_key( unsigned i );
+
     private:
-      typedef std::vector<pub_key> key_vec_t;
-      typedef std::vector<char>    ins_vec_t;
+      typedef std::vector<pub_key>  key_vec_t;
+      typedef std::vector<char>     ins_vec_t;
+      typedef std::vector<unsigned> idx_vec_t;
       uint64_t bslot_;
       commitment cmt_;
-      pub_key   *gkey_;
+      pub_key_b58 gkey_;
       key_vec_t  kvec_;
       ins_vec_t  ibuf_;
+      idx_vec_t  avec_;
       uint64_t   fee_;
       str        tx_err_;
       bool       is_end_;
@@ -888,17 +916,78 @@ namespace pc
                       uint64_t pub_slot, bool is_aggregate );
       void build( net_wtr& ) override;
 
+      // request is queued in a upd_prices transaction not yet sent
+      bool get_is_pending() const;
+
     private:
       hash         *bhash_;
       key_pair     *pkey_;
       key_cache    *ckey_;
       pub_key      *gkey_;
+      friend class upd_prices;
+
       pub_key      *akey_;
       int64_t       price_;
       uint64_t      conf_;
       uint64_t      pub_slot_;;
+      uint64_t      sent_slot_; // pub_slot of last packed transaction
       command_t     cmd_;
       symbol_status st_;
+      bool          is_pend_;
+    };
+
+    // packs upd_price instructions for different price accounts into
+    // one transaction under a single publisher signature. all requests
+    // must share the same publisher, program and block hash. the oracle
+    // rejects a pub_slot at or below the last one accepted and that fails
+    // every instruction of the transaction, so a price already sent in
+    // the current slot is held back until a later slot
+    class upd_prices : public tx_request
+    {
+    public:
+      // serialized size of fixed part and of each price
+      static const size_t fix_size   = 198;
+      static const size_t price_size = 78;
+
+      // max number of prices that fit in one transaction
+      static const unsigned max_num  =
+        ( PC_TX_MAX_SIZE - fix_size ) / price_size;
+
+      upd_prices();
+
+      // add request to transaction. returns false if full. adding a
+      // pending or held request is a no-op as it is sent with its latest
+      // price
+      bool add( upd_price * );
+
+      // current slot. prices are restamped with it when built
+      void set_slot( uint64_t );
+
+      // move held prices that may be sent in the current slot into the
+      // transaction. returns false if none were moved
+      bool release();
+
+      // number of prices in transaction
+      unsigned get_num() const;
+
+      // number of prices held back until a later slot
+      unsigned get_num_held() const;
+
+      // serialized size of transaction with num prices
+      static size_t get_size( unsigned num );
+
+      void reset();
+      void build( net_wtr& ) override;
+
+    private:
+      typedef std::vector<upd_price*> req_vec_t;
+
+      bool get_is_sent( upd_price * ) const;
+
+      unsigned   num_;
+      uint64_t   slot_;
+      upd_price *req_[max_num];
+      req_vec_t  hvec_;
     };
 
   }
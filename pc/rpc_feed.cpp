@@ -0,0 +1,256 @@
+#include "rpc_feed.hpp"
+#include "log.hpp"
+
+#define PC_FEED_WS_PORT       8900
+#define PC_FEED_RECONNECT_TIMEOUT  (120L*1000000000L)
+
+using namespace pc;
+
+///////////////////////////////////////////////////////////////////////////
+// rpc_feed_sub
+
+rpc_feed_sub::~rpc_feed_sub()
+{
+}
+
+///////////////////////////////////////////////////////////////////////////
+// feed_stats
+
+feed_stats::feed_stats()
+: num_upd_( 0UL ),
+  num_win_( 0UL ),
+  lag_( 0L )
+{
+}
+
+uint64_t feed_stats::get_num_upd() const
+{
+  return num_upd_;
+}
+
+uint64_t feed_stats::get_num_win() const
+{
+  return num_win_;
+}
+
+double feed_stats::get_win_rate() const
+{
+  return num_upd_ ? (100.*num_win_)/num_upd_ : 0.;
+}
+
+int64_t feed_stats::get_lag() const
+{
+  return lag_;
+}
+
+void feed_stats::add_win()
+{
+  ++num_upd_;
+  ++num_win_;
+}
+
+void feed_stats::add_loss( int64_t lag )
+{
+  ++num_upd_;
+  if ( lag > 0 ) {
+    lag_ = lag_ ? lag_ + ( lag - lag_ ) / 8 : lag;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////
+// feed_race
+
+bool feed_race::add( const pub_key& acc, uint64_t slot, int64_t now,
+                     feed_stats& st )
+{
+  race_map_t::iter_t rt = rmap_.find( acc );
+  if ( !rt ) {
+    rt = rmap_.add( acc );
+    rmap_.ref( rt ).slot_ = 0UL;
+  }
+  race_slot& rs = rmap_.ref( rt );
+  if ( slot <= rs.slot_ ) {
+    st.add_loss( slot == rs.slot_ ? now - rs.ts_ : 0L );
+    return false;
+  }
+  rs.slot_ = slot;
+  rs.ts_   = now;
+  st.add_win();
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// ws_failover
+
+ws_failover::ws_failover()
+: wfail_( false ),
+  wts_( 0L )
+{
+}
+
+bool ws_failover::get_is_fail() const
+{
+  return wfail_;
+}
+
+ws_failover::action_t ws_failover::check(
+    bool is_live, bool is_wait, bool is_err, int64_t now )
+{
+  // fall back to full reconnect if no other feed is live
+  if ( !is_live ) {
+    wfail_ = false;
+    return e_reconnect_all;
+  }
+  if ( !wfail_ ) {
+    wfail_ = true;
+    wts_ = 0L;
+  }
+  if ( is_wait ) {
+    return e_wait;
+  }
+  if ( is_err ) {
+    if ( now - wts_ > PC_NSECS_IN_SEC ) {
+      wts_ = now;
+      return e_connect;
+    }
+    return e_wait;
+  }
+  wfail_ = false;
+  return e_resubscribe;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// rpc_feed
+
+rpc_feed::rpc_feed()
+: sub_( nullptr ),
+  is_sub_( false ),
+  cts_( 0L ),
+  ctimeout_( PC_NSECS_IN_SEC )
+{
+  sreq_->set_sub( this );
+  preq_->set_sub( this );
+}
+
+void rpc_feed::set_host( const std::string& host )
+{
+  host_ = host;
+}
+
+std::string rpc_feed::get_host() const
+{
+  return host_;
+}
+
+void rpc_feed::set_sub( rpc_feed_sub *sub )
+{
+  sub_ = sub;
+}
+
+void rpc_feed::set_program( pub_key *pkey )
+{
+  preq_->set_program( pkey );
+}
+
+void rpc_feed::set_commitment( commitment cmt )
+{
+  preq_->set_commitment( cmt );
+}
+
+bool rpc_feed::init( net_loop *nl )
+{
+  int rport = 0, wport = 0;
+  std::string rhost = get_host_port( host_, rport, wport );
+  if ( wport == 0 ) wport = rport ? rport+1 : PC_FEED_WS_PORT;
+  wconn_.set_port( wport );
+  wconn_.set_host( rhost );
+  wconn_.set_net_loop( nl );
+  clnt_.set_ws_conn( &wconn_ );
+  cts_ = get_now();
+  if ( !wconn_.init() ) {
+    return set_err_msg( wconn_.get_err_msg() );
+  }
+  return true;
+}
+
+void rpc_feed::poll()
+{
+  if ( is_sub_ ) {
+    wconn_.poll();
+  }
+}
+
+void rpc_feed::check( int64_t now )
+{
+  // wait for connect to complete then subscribe
+  if ( wconn_.get_is_wait() ) {
+    wconn_.check();
+    if ( wconn_.get_is_wait() ) {
+      return;
+    }
+  }
+  if ( !wconn_.get_is_err() && !get_is_err() ) {
+    if ( !is_sub_ ) {
+      PC_LOG_INF( "rpc_feed_connected" ).add( "host", host_ ).end();
+      clnt_.reset();
+      clnt_.send( sreq_ );
+      clnt_.send( preq_ );
+      is_sub_ = true;
+      ctimeout_ = PC_NSECS_IN_SEC;
+    }
+    return;
+  }
+
+  // log disconnect and reconnect with back-off
+  if ( is_sub_ ) {
+    PC_LOG_ERR( "rpc_feed_reset" )
+      .add( "host", host_ )
+      .add( "error", get_is_err() ? get_err_msg() : wconn_.get_err_msg() )
+      .end();
+    is_sub_ = false;
+  }
+  if ( ctimeout_ > ( now - cts_ ) ) {
+    return;
+  }
+  cts_ = now;
+  ctimeout_ += ctimeout_;
+  ctimeout_ = std::min( ctimeout_, PC_FEED_RECONNECT_TIMEOUT );
+  reset_err();
+  wconn_.init();
+}
+
+bool rpc_feed::get_is_live() const
+{
+  return is_sub_ && !wconn_.get_is_err() && !get_is_err();
+}
+
+void rpc_feed::close()
+{
+  wconn_.close();
+  is_sub_ = false;
+}
+
+void rpc_feed::on_response( rpc::slot_subscribe *res )
+{
+  if ( PC_UNLIKELY( res->get_is_err() ) ) {
+    set_err_msg( "failed to slot_subscribe [" + res->get_err_msg() + "]" );
+    res->reset_err();
+    return;
+  }
+  if ( sub_ ) {
+    sub_->on_feed( this, res );
+  }
+}
+
+void rpc_feed::on_response( rpc::program_subscribe *res )
+{
+  if ( PC_UNLIKELY( res->get_is_err() ) ) {
+    set_err_msg( "failed to program_subscribe [" +
+                 res->get_err_msg() + "]" );
+    res->reset_err();
+    return;
+  }
+  if ( sub_ ) {
+    sub_->on_feed( this, res );
+  }
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <pc/net_socket.hpp>
+#include <pc/rpc_client.hpp>
+#include <pc/hash_map.hpp>
+
+namespace pc
+{
+
+  class rpc_feed;
+
+  // receiver of updates from redundant rpc feeds
+  class rpc_feed_sub
+  {
+  public:
+    virtual ~rpc_feed_sub();
+    virtual void on_feed( rpc_feed *, rpc::slot_subscribe * ) = 0;
+    virtual void on_feed( rpc_feed *, rpc::program_subscribe * ) = 0;
+  };
+
+  // account update race statistics of one rpc endpoint
+  class feed_stats
+  {
+  public:
+    feed_stats();
+
+    // number of account updates received
+    uint64_t get_num_upd() const;
+
+    // number of account updates received before any other endpoint
+    uint64_t get_num_win() const;
+
+    // percentage of account updates won
+    double get_win_rate() const;
+
+    // moving average of delay behind winning endpoint in nanoseconds
+    int64_t get_lag() const;
+
+    // record update that won or lost (lag is zero if unknown)
+    void add_win();
+    void add_loss( int64_t lag );
+
+  private:
+    uint64_t num_upd_;
+    uint64_t num_win_;
+    int64_t  lag_;
+  };
+
+  // first-arrival filter of account updates racing across rpc feeds
+  class feed_race
+  {
+  public:
+
+    // true if this is the first copy of an account update for its slot.
+    // records a win or a loss with delay behind the winner in feed_stats
+    bool add( const pub_key&, uint64_t slot, int64_t now, feed_stats& );
+
+  private:
+
+    // slot and arrival time of latest account update across feeds
+    struct race_slot {
+      uint64_t slot_;
+      int64_t  ts_;
+    };
+
+    struct trait_race {
+      static const size_t hsize_ = 8363UL;
+      typedef uint32_t        idx_t;
+      typedef pub_key         key_t;
+      typedef const pub_key&  keyref_t;
+      typedef race_slot       val_t;
+      struct hash_t {
+        idx_t operator() ( keyref_t a ) {
+          uint64_t *i = (uint64_t*)a.data();
+          return *i;
+        }
+      };
+    };
+
+    typedef hash_map<trait_race> race_map_t;
+
+    race_map_t rmap_;
+  };
+
+  // failover of a primary websocket to racing feeds. while any feed is
+  // live a failed primary websocket is reconnected on its own instead
+  // of tearing down all rpc connections
+  class ws_failover
+  {
+  public:
+
+    enum action_t {
+      e_reconnect_all,  // no live feed so reconnect all rpc connections
+      e_wait,           // keep publishing on feeds
+      e_connect,        // (re)start websocket connect
+      e_resubscribe     // websocket reconnected so resubscribe
+    };
+
+    ws_failover();
+
+    // primary websocket has failed over
+    bool get_is_fail() const;
+
+    // next step given feed liveness and primary websocket state
+    action_t check( bool is_live, bool is_wait, bool is_err, int64_t now );
+
+  private:
+    bool    wfail_;     // failing over primary websocket to feeds
+    int64_t wts_;       // primary websocket reconnect timestamp
+  };
+
+  // websocket-only connection to an additional rpc node subscribed to
+  // slot and program account updates. reconnects and resubscribes on
+  // its own without disturbing the other connections of the manager
+  class rpc_feed : public error,
+                   public feed_stats,
+                   public rpc_sub,
+                   public rpc_sub_i<rpc::slot_subscribe>,
+                   public rpc_sub_i<rpc::program_subscribe>
+  {
+  public:
+    rpc_feed();
+
+    // rpc host in the form host_name[:rpc_port[:ws_port]]
+    void set_host( const std::string& );
+    std::string get_host() const;
+
+    // update callback
+    void set_sub( rpc_feed_sub * );
+
+    // subscription parameters
+    void set_program( pub_key * );
+    void set_commitment( commitment );
+
+    // add to net_loop and start connecting
+    bool init( net_loop * );
+
+    // poll socket when not using net_loop
+    void poll();
+
+    // reconnect with back-off and resubscribe as required
+    void check( int64_t now );
+
+    // connected and subscribed
+    bool get_is_live() const;
+
+    void close();
+
+    void on_response( rpc::slot_subscribe * ) override;
+    void on_response( rpc::program_subscribe * ) override;
+
+  private:
+    std::string         host_;      // rpc host
+    rpc_feed_sub       *sub_;       // update callback
+    ws_connect          wconn_;     // rpc websocket connection
+    rpc_client          clnt_;      // rpc api
+    bool                is_sub_;    // subscriptions sent
+    int64_t             cts_;       // (re)connect timestamp
+    int64_t             ctimeout_;  // reconnect timeout
+    rpc::slot_subscribe    sreq_[1];
+    rpc::program_subscribe preq_[1];
+  };
+
+}
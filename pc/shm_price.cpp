@@ -0,0 +1,179 @@
+#include "shm_price.hpp"
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace pc;
+
+///////////////////////////////////////////////////////////////////////////
+// shm_price_wtr
+
+shm_price_wtr::shm_price_wtr()
+: fd_( -1 ),
+  len_( 0 ),
+  buf_( nullptr ),
+  hdr_( nullptr ),
+  pvec_( nullptr ),
+  rvec_( nullptr ),
+  max_px_( 4096 ),
+  rsize_( 65536 )
+{
+}
+
+shm_price_wtr::~shm_price_wtr()
+{
+  close();
+}
+
+void shm_price_wtr::close()
+{
+  if ( buf_ ) {
+    ::munmap( buf_, len_ );
+    buf_ = nullptr;
+  }
+  if ( fd_ > 0 ) {
+    ::close( fd_ );
+    fd_ = -1;
+  }
+}
+
+void shm_price_wtr::set_file( const std::string& file )
+{
+  file_ = file;
+}
+
+std::string shm_price_wtr::get_file() const
+{
+  return file_;
+}
+
+void shm_price_wtr::set_max_price( uint32_t max_px )
+{
+  max_px_ = max_px;
+}
+
+uint32_t shm_price_wtr::get_max_price() const
+{
+  return max_px_;
+}
+
+void shm_price_wtr::set_ring_size( uint32_t rsize )
+{
+  rsize_ = rsize;
+}
+
+uint32_t shm_price_wtr::get_ring_size() const
+{
+  return rsize_;
+}
+
+bool shm_price_wtr::init()
+{
+  close();
+  if ( rsize_ == 0 || ( rsize_ & ( rsize_ - 1 ) ) ) {
+    return set_err_msg( "shm ring size not a power of 2" );
+  }
+
+  // new file so that readers of a previous region are not disturbed
+  ::unlink( file_.c_str() );
+  fd_ = ::open( file_.c_str(), O_CREAT | O_RDWR | O_EXCL, 0644 );
+  if ( fd_ < 0 ) {
+    return set_err_msg( "failed to create shm file=" + file_, errno );
+  }
+  len_ = sizeof( shm::hdr ) + max_px_ * sizeof( shm::price ) +
+    rsize_ * sizeof( shm::ring );
+  if ( 0 != ::ftruncate( fd_, len_ ) ) {
+    return set_err_msg( "failed to size shm file=" + file_, errno );
+  }
+  void *buf = ::mmap(
+      NULL, len_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0 );
+  if ( buf == MAP_FAILED ) {
+    return set_err_msg( "failed to map shm file=" + file_, errno );
+  }
+  buf_  = (char*)buf;
+  hdr_  = (shm::hdr*)buf_;
+  pvec_ = (shm::price*)&hdr_[1];
+  rvec_ = (shm::ring*)&pvec_[max_px_];
+  hdr_->max_price_ = max_px_;
+  hdr_->ring_size_ = rsize_;
+  hdr_->ver_       = shm::version;
+  __atomic_store_n( &hdr_->magic_, shm::magic, __ATOMIC_RELEASE );
+  return true;
+}
+
+void shm_price_wtr::update( uint32_t hdl, const shm::price& rec )
+{
+  if ( PC_UNLIKELY( hdl >= max_px_ ) ) {
+    return;
+  }
+
+  // seqlock write of price record
+  shm::price *ptr = &pvec_[hdl];
+  uint64_t seq = ptr->seq_;
+  __atomic_store_n( &ptr->seq_, seq + 1UL, __ATOMIC_RELAXED );
+  __atomic_thread_fence( __ATOMIC_RELEASE );
+  __builtin_memcpy( (char*)ptr + sizeof( ptr->seq_ ),
+      (const char*)&rec + sizeof( rec.seq_ ),
+      sizeof( shm::price ) - sizeof( rec.seq_ ) );
+  __atomic_store_n( &ptr->seq_, seq + 2UL, __ATOMIC_RELEASE );
+  if ( hdl >= hdr_->num_price_ ) {
+    __atomic_store_n( &hdr_->num_price_, hdl + 1, __ATOMIC_RELEASE );
+  }
+
+  // publish handle on update ring
+  uint64_t head = hdr_->seq_;
+  uint64_t val = ( ( ( head + 1UL ) & 0xffffffffUL ) << 32 ) | hdl;
+  __atomic_store_n( &rvec_[head & (rsize_-1)].val_, val, __ATOMIC_RELEASE );
+  __atomic_store_n( &hdr_->seq_, head + 1UL, __ATOMIC_RELEASE );
+}
+
+///////////////////////////////////////////////////////////////////////////
+// shm_price_rdr
+
+shm_price_rdr::shm_price_rdr()
+: hdr_( nullptr ),
+  pvec_( nullptr ),
+  rvec_( nullptr ),
+  seq_( 0UL ),
+  num_ovr_( 0UL )
+{
+}
+
+void shm_price_rdr::set_file( const std::string& file )
+{
+  mf_.set_file( file );
+}
+
+std::string shm_price_rdr::get_file() const
+{
+  return mf_.get_file();
+}
+
+bool shm_price_rdr::init()
+{
+  if ( !mf_.init() ) {
+    return set_err_msg( "failed to map shm file=" + mf_.get_file() );
+  }
+  hdr_ = (const shm::hdr*)mf_.data();
+  if ( mf_.size() < sizeof( shm::hdr ) ||
+       __atomic_load_n( &hdr_->magic_, __ATOMIC_ACQUIRE ) != shm::magic ) {
+    return set_err_msg( "invalid shm file=" + mf_.get_file() );
+  }
+  if ( hdr_->ver_ != shm::version ) {
+    return set_err_msg( "invalid shm file version=" +
+        std::to_string( hdr_->ver_ ) );
+  }
+  size_t len = sizeof( shm::hdr ) +
+    hdr_->max_price_ * sizeof( shm::price ) +
+    hdr_->ring_size_ * sizeof( shm::ring );
+  if ( mf_.size() < len ) {
+    return set_err_msg( "truncated shm file=" + mf_.get_file() );
+  }
+  pvec_ = (const shm::price*)&hdr_[1];
+  rvec_ = (const shm::ring*)&pvec_[hdr_->max_price_];
+  seq_  = __atomic_load_n( &hdr_->seq_, __ATOMIC_ACQUIRE );
+  num_ovr_ = 0UL;
+  return true;
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <pc/mem_map.hpp>
+#include <pc/error.hpp>
+#include <pc/misc.hpp>
+
+namespace pc
+{
+
+  // shared-memory aggregate price feed for co-located readers. the
+  // region holds a hdr, a table of seqlock-protected price records
+  // indexed by price handle and a ring of updated price handles
+  namespace shm
+  {
+    static const uint32_t magic   = 0x68747970; // "pyth"
+    static const uint32_t version = 1;
+
+    struct hdr
+    {
+      uint32_t magic_;        // shm::magic
+      uint32_t ver_;          // shm::version
+      uint32_t max_price_;    // size of price table
+      uint32_t ring_size_;    // size of update ring (power of 2)
+      uint32_t num_price_;    // one past highest price handle written
+      uint32_t unused_;
+      uint64_t seq_;          // number of updates written to ring
+      uint64_t pad_[5];
+    };
+
+    struct price
+    {
+      uint64_t seq_;          // seqlock sequence (odd while writing)
+      uint8_t  acc_[32];      // price account key
+      int64_t  price_;        // aggregate price
+      uint64_t conf_;         // aggregate confidence interval
+      int64_t  twap_;         // time-weighted average price
+      uint64_t twac_;         // time-weighted average confidence
+      uint64_t valid_slot_;   // slot of previous aggregate update
+      uint64_t pub_slot_;     // publish slot of aggregate
+      int64_t  ts_;           // receive time in nanoseconds from epoch
+      uint32_t status_;       // aggregate symbol_status
+      uint32_t num_qt_;       // number of quoters in aggregate
+      int32_t  expo_;         // price exponent
+      uint32_t unused_;
+      uint64_t pad_;
+    };
+
+    // ring entry: low 32 bits of (sequence+1) above price handle
+    struct ring
+    {
+      uint64_t val_;
+    };
+  }
+
+  // single writer of shared-memory price feed
+  class shm_price_wtr : public error
+  {
+  public:
+
+    shm_price_wtr();
+    ~shm_price_wtr();
+
+    // shared-memory file (e.g. /dev/shm/pythd_price)
+    void set_file( const std::string& );
+    std::string get_file() const;
+
+    // price table capacity (default 4096)
+    void set_max_price( uint32_t );
+    uint32_t get_max_price() const;
+
+    // update ring capacity as power of 2 (default 65536)
+    void set_ring_size( uint32_t );
+    uint32_t get_ring_size() const;
+
+    // replace any previous file with new zeroed region
+    bool init();
+
+    // write price record and append handle to update ring
+    void update( uint32_t hdl, const shm::price& );
+
+  private:
+    void close();
+
+    int          fd_;
+    size_t       len_;
+    char        *buf_;
+    shm::hdr    *hdr_;
+    shm::price  *pvec_;
+    shm::ring   *rvec_;
+    uint32_t     max_px_;
+    uint32_t     rsize_;
+    std::string  file_;
+  };
+
+  // zero-syscall reader of shared-memory price feed
+  class shm_price_rdr : public error
+  {
+  public:
+
+    shm_price_rdr();
+
+    // shared-memory file written by pythd
+    void set_file( const std::string& );
+    std::string get_file() const;
+
+    // map file and start reading updates from current ring position
+    bool init();
+
+    // one past highest price handle written
+    uint32_t get_num_price() const;
+
+    // consistent copy of price record (false if not written)
+    bool get_price( uint32_t hdl, shm::price& ) const;
+
+    // next updated price handle (false if no new update)
+    bool get_next( uint32_t& hdl );
+
+    // number of times reader fell behind the update ring. updates
+    // were lost so all prices should be re-read
+    uint64_t get_num_overrun() const;
+
+  private:
+    const shm::hdr   *hdr_;
+    const shm::price *pvec_;
+    const shm::ring  *rvec_;
+    uint64_t          seq_;
+    uint64_t          num_ovr_;
+    mem_map           mf_;
+  };
+
+  inline uint32_t shm_price_rdr::get_num_price() const
+  {
+    return __atomic_load_n( &hdr_->num_price_, __ATOMIC_ACQUIRE );
+  }
+
+  inline bool shm_price_rdr::get_price(
+      uint32_t hdl, shm::price& res ) const
+  {
+    if ( hdl >= get_num_price() ) {
+      return false;
+    }
+    const shm::price *ptr = &pvec_[hdl];
+    for(;;) {
+      uint64_t seq = __atomic_load_n( &ptr->seq_, __ATOMIC_ACQUIRE );
+      if ( seq & 1UL ) {
+        continue;
+      }
+      __builtin_memcpy( &res, ptr, sizeof( shm::price ) );
+      __atomic_thread_fence( __ATOMIC_ACQUIRE );
+      if ( seq == __atomic_load_n( &ptr->seq_, __ATOMIC_RELAXED ) ) {
+        res.seq_ = seq;
+        return seq != 0UL;
+      }
+    }
+  }
+
+  inline bool shm_price_rdr::get_next( uint32_t& hdl )
+  {
+    uint64_t head = __atomic_load_n( &hdr_->seq_, __ATOMIC_ACQUIRE );
+    if ( seq_ == head ) {
+      return false;
+    }
+    uint64_t val = __atomic_load_n(
+        &rvec_[seq_ & (hdr_->ring_size_-1)].val_, __ATOMIC_ACQUIRE );
+    if ( PC_UNLIKELY( (val>>32) != ((seq_+1UL) & 0xffffffffUL) ) ) {
+      // entry overwritten - skip to head of ring
+      ++num_ovr_;
+      seq_ = head;
+      return false;
+    }
+    hdl = (uint32_t)val;
+    ++seq_;
+    return true;
+  }
+
+  inline uint64_t shm_price_rdr::get_num_overrun() const
+  {
+    return num_ovr_;
+  }
+
+}
@@ -0,0 +1,239 @@
+#include "shm_upd.hpp"
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace pc;
+
+///////////////////////////////////////////////////////////////////////////
+// shm_upd_rdr
+
+shm_upd_rdr::shm_upd_rdr()
+: len_( 0 ),
+  buf_( nullptr ),
+  hdr_( nullptr ),
+  ring_( nullptr ),
+  size_( 4096 )
+{
+}
+
+shm_upd_rdr::~shm_upd_rdr()
+{
+  unmap();
+  close();
+}
+
+void shm_upd_rdr::unmap()
+{
+  if ( buf_ ) {
+    ::munmap( buf_, len_ );
+    buf_ = nullptr;
+  }
+}
+
+void shm_upd_rdr::set_file( const std::string& file )
+{
+  file_ = file;
+}
+
+std::string shm_upd_rdr::get_file() const
+{
+  return file_;
+}
+
+void shm_upd_rdr::set_ring_size( uint32_t size )
+{
+  size_ = size;
+}
+
+uint32_t shm_upd_rdr::get_ring_size() const
+{
+  return size_;
+}
+
+bool shm_upd_rdr::init()
+{
+  unmap();
+  close();
+  if ( size_ == 0 || ( size_ & ( size_ - 1 ) ) ) {
+    return set_err_msg( "shm ring size not a power of 2" );
+  }
+
+  // create ring in new file
+  ::unlink( file_.c_str() );
+  int fd = ::open( file_.c_str(), O_CREAT | O_RDWR | O_EXCL, 0666 );
+  if ( fd < 0 ) {
+    return set_err_msg( "failed to create shm file=" + file_, errno );
+  }
+  len_ = sizeof( shm::upd_hdr ) + size_ * sizeof( shm::upd );
+  if ( 0 != ::ftruncate( fd, len_ ) ) {
+    ::close( fd );
+    return set_err_msg( "failed to size shm file=" + file_, errno );
+  }
+  void *buf = ::mmap( NULL, len_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close( fd );
+  if ( buf == MAP_FAILED ) {
+    return set_err_msg( "failed to map shm file=" + file_, errno );
+  }
+  buf_  = (char*)buf;
+  hdr_  = (shm::upd_hdr*)buf_;
+  ring_ = (shm::upd*)&hdr_[1];
+  for( uint32_t i=0; i != size_; ++i ) {
+    ring_[i].seq_ = i;
+  }
+  hdr_->size_ = size_;
+  hdr_->ver_  = shm::upd_version;
+  __atomic_store_n( &hdr_->magic_, shm::upd_magic, __ATOMIC_RELEASE );
+
+  // wakeup fifo held open for read and write so it never signals eof
+  std::string wfile = file_ + ".wake";
+  ::unlink( wfile.c_str() );
+  if ( 0 != ::mkfifo( wfile.c_str(), 0666 ) ) {
+    return set_err_msg( "failed to create fifo=" + wfile, errno );
+  }
+  fd = ::open( wfile.c_str(), O_RDWR | O_NONBLOCK );
+  if ( fd < 0 ) {
+    return set_err_msg( "failed to open fifo=" + wfile, errno );
+  }
+  set_fd( fd );
+  if ( get_net_loop() ) {
+    get_net_loop()->add( this, EPOLLIN );
+  }
+  return true;
+}
+
+bool shm_upd_rdr::set_wait()
+{
+  __atomic_store_n( &hdr_->wait_, 1, __ATOMIC_RELAXED );
+  __atomic_thread_fence( __ATOMIC_SEQ_CST );
+  uint64_t tail = hdr_->tail_;
+  shm::upd *ptr = &ring_[tail & (size_-1)];
+  return __atomic_load_n( &ptr->seq_, __ATOMIC_ACQUIRE ) != tail + 1UL;
+}
+
+void shm_upd_rdr::reset_wait()
+{
+  __atomic_store_n( &hdr_->wait_, 0, __ATOMIC_RELAXED );
+}
+
+void shm_upd_rdr::poll()
+{
+  char buf[256];
+  while( ::read( get_fd(), buf, sizeof( buf ) ) > 0 );
+}
+
+///////////////////////////////////////////////////////////////////////////
+// shm_upd_wtr
+
+shm_upd_wtr::shm_upd_wtr()
+: wfd_( -1 ),
+  len_( 0 ),
+  buf_( nullptr ),
+  hdr_( nullptr ),
+  ring_( nullptr )
+{
+}
+
+shm_upd_wtr::~shm_upd_wtr()
+{
+  close();
+}
+
+void shm_upd_wtr::close()
+{
+  if ( buf_ ) {
+    ::munmap( buf_, len_ );
+    buf_ = nullptr;
+  }
+  if ( wfd_ >= 0 ) {
+    ::close( wfd_ );
+    wfd_ = -1;
+  }
+}
+
+void shm_upd_wtr::set_file( const std::string& file )
+{
+  file_ = file;
+}
+
+std::string shm_upd_wtr::get_file() const
+{
+  return file_;
+}
+
+bool shm_upd_wtr::init()
+{
+  close();
+  int fd = ::open( file_.c_str(), O_RDWR );
+  if ( fd < 0 ) {
+    return set_err_msg( "failed to open shm file=" + file_, errno );
+  }
+  struct stat fst[1];
+  if ( 0 != ::fstat( fd, fst ) ||
+       (size_t)fst->st_size < sizeof( shm::upd_hdr ) ) {
+    ::close( fd );
+    return set_err_msg( "invalid shm file=" + file_ );
+  }
+  len_ = fst->st_size;
+  void *buf = ::mmap( NULL, len_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close( fd );
+  if ( buf == MAP_FAILED ) {
+    return set_err_msg( "failed to map shm file=" + file_, errno );
+  }
+  buf_  = (char*)buf;
+  hdr_  = (shm::upd_hdr*)buf_;
+  ring_ = (shm::upd*)&hdr_[1];
+  if ( __atomic_load_n( &hdr_->magic_, __ATOMIC_ACQUIRE ) != shm::upd_magic ||
+       hdr_->ver_ != shm::upd_version ||
+       len_ < sizeof( shm::upd_hdr ) + hdr_->size_ * sizeof( shm::upd ) ) {
+    return set_err_msg( "invalid shm file=" + file_ );
+  }
+
+  // wakeups are best effort
+  std::string wfile = file_ + ".wake";
+  wfd_ = ::open( wfile.c_str(), O_WRONLY | O_NONBLOCK );
+  return true;
+}
+
+bool shm_upd_wtr::add(
+    uint32_t hdl, int64_t price, uint64_t conf, uint32_t status )
+{
+  // claim slot
+  uint64_t mask = hdr_->size_ - 1;
+  uint64_t pos = __atomic_load_n( &hdr_->head_, __ATOMIC_RELAXED );
+  shm::upd *ptr;
+  for(;;) {
+    ptr = &ring_[pos & mask];
+    uint64_t seq = __atomic_load_n( &ptr->seq_, __ATOMIC_ACQUIRE );
+    if ( seq == pos ) {
+      if ( __atomic_compare_exchange_n( &hdr_->head_, &pos, pos + 1UL,
+            true, __ATOMIC_RELAXED, __ATOMIC_RELAXED ) ) {
+        break;
+      }
+    } else if ( seq < pos ) {
+      return false;
+    } else {
+      pos = __atomic_load_n( &hdr_->head_, __ATOMIC_RELAXED );
+    }
+  }
+
+  // fill and release slot to pythd
+  ptr->handle_ = hdl;
+  ptr->status_ = status;
+  ptr->price_  = price;
+  ptr->conf_   = conf;
+  __atomic_store_n( &ptr->seq_, pos + 1UL, __ATOMIC_RELEASE );
+
+  // wake pythd if blocked
+  __atomic_thread_fence( __ATOMIC_SEQ_CST );
+  if ( __atomic_load_n( &hdr_->wait_, __ATOMIC_RELAXED ) && wfd_ >= 0 ) {
+    __atomic_store_n( &hdr_->wait_, 0, __ATOMIC_RELAXED );
+    char c = 0;
+    if ( ::write( wfd_, &c, 1 ) < 0 ) {
+      // fifo full - pythd is awake already
+    }
+  }
+  return true;
+}
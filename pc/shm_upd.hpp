@@ -0,0 +1,124 @@
+#pragma once
+
+#include <pc/net_socket.hpp>
+#include <pc/misc.hpp>
+
+namespace pc
+{
+
+  // shared-memory price update ingress for publishers co-located with
+  // pythd. publishers claim slots of a bounded multi-producer ring and
+  // pythd drains it every poll. a named fifo next to the ring wakes the
+  // pythd event loop when it is blocked waiting for events
+  namespace shm
+  {
+    static const uint32_t upd_magic   = 0x64707570; // "pupd"
+    static const uint32_t upd_version = 1;
+
+    struct upd_hdr
+    {
+      uint32_t magic_;        // shm::upd_magic
+      uint32_t ver_;          // shm::upd_version
+      uint32_t size_;         // number of ring slots (power of 2)
+      uint32_t wait_;         // non-zero while pythd is blocked
+      uint64_t pad1_[6];
+      uint64_t head_;         // next slot claimed by publishers
+      uint64_t pad2_[7];
+      uint64_t tail_;         // next slot drained by pythd
+      uint64_t pad3_[7];
+    };
+
+    struct upd
+    {
+      uint64_t seq_;          // slot sequence
+      uint32_t handle_;       // price handle
+      uint32_t status_;       // symbol_status
+      int64_t  price_;        // price in units of exponent
+      uint64_t conf_;         // confidence interval
+    };
+  }
+
+  // pythd side of update ingress: creates ring and wakeup fifo
+  class shm_upd_rdr : public net_socket
+  {
+  public:
+
+    shm_upd_rdr();
+    ~shm_upd_rdr();
+
+    // shared-memory ring file. wakeup fifo is file + ".wake"
+    void set_file( const std::string& );
+    std::string get_file() const;
+
+    // ring capacity as power of 2 (default 4096)
+    void set_ring_size( uint32_t );
+    uint32_t get_ring_size() const;
+
+    // replace any previous ring with new empty ring
+    bool init() override;
+
+    // next published update (false if ring is empty)
+    bool get_next( shm::upd& );
+
+    // ask publishers for a wakeup. returns false if updates are already
+    // queued in which case event loop should not block
+    bool set_wait();
+    void reset_wait();
+
+    // drain wakeup fifo
+    void poll() override;
+
+  private:
+    void unmap();
+
+    size_t       len_;
+    char        *buf_;
+    shm::upd_hdr *hdr_;
+    shm::upd    *ring_;
+    uint32_t     size_;
+    std::string  file_;
+  };
+
+  // publisher side of update ingress
+  class shm_upd_wtr : public error
+  {
+  public:
+
+    shm_upd_wtr();
+    ~shm_upd_wtr();
+
+    // shared-memory ring file created by pythd
+    void set_file( const std::string& );
+    std::string get_file() const;
+
+    // map ring and open wakeup fifo
+    bool init();
+
+    // queue price update. false if ring is full
+    bool add( uint32_t hdl, int64_t price, uint64_t conf, uint32_t status );
+
+  private:
+    void close();
+
+    int          wfd_;
+    size_t       len_;
+    char        *buf_;
+    shm::upd_hdr *hdr_;
+    shm::upd    *ring_;
+    std::string  file_;
+  };
+
+  inline bool shm_upd_rdr::get_next( shm::upd& res )
+  {
+    uint64_t tail = hdr_->tail_;
+    shm::upd *ptr = &ring_[tail & (size_-1)];
+    if ( __atomic_load_n( &ptr->seq_, __ATOMIC_ACQUIRE ) != tail + 1UL ) {
+      return false;
+    }
+    res = *ptr;
+    __atomic_store_n( &ptr->seq_, tail + size_, __ATOMIC_RELEASE );
+    __atomic_store_n( &hdr_->tail_, tail + 1UL, __ATOMIC_RELAXED );
+    return true;
+  }
+
+}
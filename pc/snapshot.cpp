@@ -0,0 +1,122 @@
+#include "snapshot.hpp"
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdio.h>
+
+using namespace pc;
+
+snapshot::snapshot()
+: up_( nullptr ),
+  pos_( 0 ),
+  num_( 0 )
+{
+}
+
+void snapshot::set_file( const std::string& file )
+{
+  file_ = file;
+}
+
+std::string snapshot::get_file() const
+{
+  return file_;
+}
+
+void snapshot::add(
+    uint64_t slot, const pc_pub_key_t *kptr, const pc_acc_t *aptr )
+{
+  if ( aptr->size_ < sizeof( pc_acc_t ) ) {
+    return;
+  }
+  if ( buf_.empty() ) {
+    buf_.resize( sizeof( file_hdr ) );
+  }
+  size_t tlen = sizeof( uint64_t ) + sizeof( pc_pub_key_t ) + aptr->size_;
+  size_t pos = buf_.size();
+  buf_.resize( pos + ( ( tlen + 7UL ) & ~7UL ), '\0' );
+  hdr *tgt = (hdr*)&buf_[pos];
+  tgt->slot_ = slot;
+  pc_pub_key_assign( &tgt->key_, (pc_pub_key_t*)kptr );
+  __builtin_memcpy( &tgt->acc_, aptr, aptr->size_ );
+  ++num_;
+}
+
+uint32_t snapshot::get_num() const
+{
+  return num_;
+}
+
+bool snapshot::save()
+{
+  if ( buf_.empty() ) {
+    return true;
+  }
+  file_hdr *fhdr = (file_hdr*)&buf_[0];
+  fhdr->magic_  = PC_MAGIC;
+  fhdr->ver_    = PC_VERSION;
+  fhdr->num_    = num_;
+  fhdr->unused_ = 0;
+
+  // write to temporary file and move over previous snapshot
+  std::string tmp = file_ + ".tmp";
+  int fd = ::open( tmp.c_str(), O_CREAT | O_WRONLY | O_TRUNC, 0644 );
+  if ( fd < 0 ) {
+    return set_err_msg( "failed to create snapshot file=" + tmp, errno );
+  }
+  const char *buf = buf_.c_str();
+  size_t sz = buf_.size();
+  while( sz > 0 ) {
+    ssize_t num = ::write( fd, buf, sz );
+    if ( num <= 0 ) {
+      ::close( fd );
+      return set_err_msg( "failed to write snapshot file=" + tmp, errno );
+    }
+    buf += num;
+    sz  -= num;
+  }
+  ::close( fd );
+  buf_.clear();
+  num_ = 0;
+  if ( 0 != ::rename( tmp.c_str(), file_.c_str() ) ) {
+    return set_err_msg( "failed to rename snapshot file=" + tmp, errno );
+  }
+  return true;
+}
+
+bool snapshot::init()
+{
+  up_ = nullptr;
+  pos_ = 0;
+  mf_.set_file( file_ );
+  if ( !mf_.init() ) {
+    return set_err_msg( "failed to map snapshot file=" + file_ );
+  }
+  const file_hdr *fhdr = (const file_hdr*)mf_.data();
+  if ( mf_.size() < sizeof( file_hdr ) || fhdr->magic_ != PC_MAGIC ) {
+    return set_err_msg( "invalid or corrupt snapshot file=" + file_ );
+  }
+  if ( fhdr->ver_ != PC_VERSION ) {
+    return set_err_msg( "invalid snapshot file version=" +
+        std::to_string( fhdr->ver_ ) );
+  }
+  pos_ = sizeof( file_hdr );
+  return true;
+}
+
+bool snapshot::get_next()
+{
+  static const size_t hlen = sizeof( uint64_t ) + sizeof( pc_pub_key_t );
+  if ( pos_ + sizeof( hdr ) > mf_.size() ) {
+    return false;
+  }
+  hdr *up = (hdr*)( mf_.data() + pos_ );
+  size_t tlen = hlen + up->acc_.size_;
+  if ( up->acc_.size_ < sizeof( pc_acc_t ) || pos_ + tlen > mf_.size() ) {
+    return false;
+  }
+  up_ = up;
+  pos_ += ( tlen + 7UL ) & ~7UL;
+  return true;
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <pc/mem_map.hpp>
+#include <pc/error.hpp>
+#include <oracle/oracle.h>
+
+namespace pc
+{
+
+  // warm-start snapshot of mapping, product and price account images.
+  // records use the capture file layout with the slot of the latest
+  // account update in place of the capture time, padded to 8 bytes.
+  // a loaded record doubles as an account update to the request objects
+  class snapshot : public error
+  {
+  public:
+
+    snapshot();
+
+    // snapshot file
+    void set_file( const std::string& );
+    std::string get_file() const;
+
+    // add account image to snapshot under construction
+    void add( uint64_t slot, const pc_pub_key_t *, const pc_acc_t * );
+
+    // number of accounts added since last save
+    uint32_t get_num() const;
+
+    // replace snapshot file with accounts added since last save
+    bool save();
+
+    // map existing snapshot file for reading
+    bool init();
+
+    // advance to next account record
+    bool get_next();
+
+    // current account record
+    uint64_t      get_slot() const;
+    pc_pub_key_t *get_account() const;
+    pc_acc_t     *get_update() const;
+
+    // account update interface as per rpc::get_account_info
+    uint64_t get_lamports() const;
+    template<class T>
+    size_t get_data_ref( T *&, size_t tlen=sizeof(T) );
+    template<class T>
+    size_t get_data_val( T *, size_t tlen=sizeof(T) ) const;
+
+  private:
+
+    struct file_hdr
+    {
+      uint32_t     magic_;
+      uint32_t     ver_;
+      uint32_t     num_;
+      uint32_t     unused_;
+    };
+
+    struct hdr
+    {
+      uint64_t     slot_;
+      pc_pub_key_t key_;
+      pc_acc_t     acc_;
+    };
+
+    hdr        *up_;
+    size_t      pos_;
+    uint32_t    num_;
+    mem_map     mf_;
+    std::string buf_;
+    std::string dbuf_;
+    std::string file_;
+  };
+
+  inline uint64_t snapshot::get_slot() const
+  {
+    return up_->slot_;
+  }
+
+  inline pc_pub_key_t *snapshot::get_account() const
+  {
+    return &up_->key_;
+  }
+
+  inline pc_acc_t *snapshot::get_update() const
+  {
+    return &up_->acc_;
+  }
+
+  inline uint64_t snapshot::get_lamports() const
+  {
+    return 0UL;
+  }
+
+  template<class T>
+  size_t snapshot::get_data_ref( T *&res, size_t tlen )
+  {
+    // copy to zero-padded buffer at least the size of the account type
+    dbuf_.assign( (const char*)&up_->acc_, up_->acc_.size_ );
+    if ( dbuf_.size() < tlen ) {
+      dbuf_.resize( tlen, '\0' );
+    }
+    res = (T*)&dbuf_[0];
+    return dbuf_.size();
+  }
+
+  template<class T>
+  size_t snapshot::get_data_val( T *res, size_t tlen ) const
+  {
+    size_t len = up_->acc_.size_ < tlen ? up_->acc_.size_ : tlen;
+    __builtin_memcpy( (char*)res, &up_->acc_, len );
+    __builtin_memset( (char*)res + len, 0, tlen - len );
+    return len;
+  }
+
+}
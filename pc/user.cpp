@@ -11,6 +11,8 @@
 #define PC_JSON_UNKNOWN_SYMBOL  -32000
 #define PC_JSON_MISSING_PERMS   -32001
 #define PC_JSON_NOT_READY       -32002
+#define PC_USER_HIGH_WATER      (1UL<<20)
+#define PC_USER_LOW_WATER       (256UL<<10)
 
 using namespace pc;
 
@@ -25,7 +27,12 @@ void user::user_http::parse_content( const char *txt, size_t len )
 user::user()
 : rptr_( nullptr ),
   sptr_( nullptr ),
-  psub_( this )
+  psub_( this ),
+  hwm_( PC_USER_HIGH_WATER ),
+  lwm_( PC_USER_LOW_WATER ),
+  nconf_( 0UL ),
+  is_slow_( false ),
+  has_bin_( false )
 {
   // setup the plumbing
   hsvr_.ptr_ = this;
@@ -44,6 +51,17 @@ void user::set_manager( manager *sptr )
   sptr_ = sptr;
 }
 
+void user::set_send_watermarks( size_t high, size_t low )
+{
+  hwm_ = high;
+  lwm_ = low;
+}
+
+uint64_t user::get_num_conflated() const
+{
+  return nconf_;
+}
+
 void user::teardown()
 {
   net_connect::teardown();
@@ -155,27 +173,73 @@ void user::parse_request( uint32_t tok )
   str mst = jp_.get_str( mtok );
   if ( mst == "update_price" ) {
     parse_upd_price( tok, itok );
+  } else if ( mst == "update_prices" ) {
+    parse_upd_prices( tok, itok );
   } else if ( mst == "subscribe_price" ) {
     parse_sub_price( tok, itok );
   } else if ( mst == "subscribe_price_sched" ) {
     parse_sub_price_sched( tok, itok );
   } else if ( mst == "get_product_list" ) {
     parse_get_product_list( itok );
+  } else if ( mst == "get_product_list_version" ) {
+    parse_get_product_list_version( itok );
   } else {
     add_error( itok, PC_JSON_UNKNOWN_METHOD, "method not found" );
   }
 }
 
+static bool get_handle( const jtree& jp, uint32_t tok, uint64_t& hdl )
+{
+  // unquoted decimal digits only. signs, fractions, exponents, strings
+  // and keywords are rejected rather than read as zero
+  if ( jp.get_type( tok ) != jtree::e_val ) {
+    return false;
+  }
+  str val = jp.get_str( tok );
+  if ( val.len_ == 0 || val.len_ > 18 || val.str_[-1] == '"' ) {
+    return false;
+  }
+  hdl = 0UL;
+  for( size_t i=0; i != val.len_; ++i ) {
+    char c = val.str_[i];
+    if ( c < '0' || c > '9' ) {
+      return false;
+    }
+    hdl = hdl*10UL + (uint64_t)( c - '0' );
+  }
+  return true;
+}
+
+bool user::find_price( uint32_t ptok, price *&sptr )
+{
+  // price handle from get_product_list or account key
+  uint32_t ntok = jp_.find_val( ptok, "handle" );
+  if ( ntok ) {
+    uint64_t hdl;
+    if ( !get_handle( jp_, ntok, hdl ) ) {
+      return false;
+    }
+    sptr = hdl < sptr_->get_num_price() ? sptr_->get_price( (uint32_t)hdl )
+                                        : nullptr;
+    return true;
+  }
+  if ( 0 == (ntok = jp_.find_val( ptok, "account" ) ) ) {
+    return false;
+  }
+  pub_key pkey;
+  pkey.init_from_text( jp_.get_str( ntok ) );
+  sptr = sptr_->get_price( pkey );
+  return true;
+}
+
 void user::parse_upd_price( uint32_t tok, uint32_t itok )
 {
   do {
     // unpack and verify parameters
     uint32_t ntok,ptok = jp_.find_val( tok, "params" );
     if ( ptok == 0 || jp_.get_type(ptok) != jtree::e_obj ) break;
-    if ( 0 == (ntok = jp_.find_val( ptok, "account" ) ) ) break;
-    pub_key pkey;
-    pkey.init_from_text( jp_.get_str( ntok ) );
-    price *sptr = sptr_->get_price( pkey );
+    price *sptr;
+    if ( !find_price( ptok, sptr ) ) break;
     if ( PC_UNLIKELY( !sptr ) ) { add_unknown_symbol(itok); return; }
     if ( 0 == (ntok = jp_.find_val( ptok, "price" ) ) ) break;
     int64_t price = jp_.get_int( ntok );
@@ -205,20 +269,110 @@ void user::parse_upd_price( uint32_t tok, uint32_t itok )
   add_invalid_params( itok );
 }
 
+static int get_upd_err( price *sptr )
+{
+  // error code of failed price update
+  if ( !sptr->get_is_ready_publish() ) {
+    return PC_JSON_NOT_READY;
+  } else if ( !sptr->has_publisher() ) {
+    return PC_JSON_MISSING_PERMS;
+  } else {
+    return PC_JSON_INVALID_REQUEST;
+  }
+}
+
+void user::parse_upd_prices( uint32_t tok, uint32_t itok )
+{
+  // validate all [handle or account, price, conf, status] tuples
+  // before publishing any of them
+  uint32_t ptok = jp_.find_val( tok, "params" );
+  if ( ptok == 0 || jp_.get_type(ptok) != jtree::e_arr ) {
+    add_invalid_params( itok );
+    return;
+  }
+  uvec_.clear();
+  for( uint32_t etok = jp_.get_first( ptok ); etok;
+       etok = jp_.get_next( etok ) ) {
+    uint32_t vtok[4], num = 0;
+    if ( jp_.get_type( etok ) == jtree::e_arr ) {
+      for( uint32_t t = jp_.get_first( etok ); t; t = jp_.get_next( t ) ) {
+        if ( num == 4 || jp_.get_type( t ) != jtree::e_val ) {
+          num = 0;
+          break;
+        }
+        vtok[num++] = t;
+      }
+    }
+    if ( num != 4 ) {
+      add_invalid_params( itok );
+      return;
+    }
+    upd_rec rec;
+    uint64_t hdl;
+    str key = jp_.get_str( vtok[0] );
+    rec.px_  = nullptr;
+    rec.err_ = 0;
+    if ( key.str_[-1] == '"' ) {
+      pub_key pkey;
+      pkey.init_from_text( key );
+      rec.px_ = sptr_->get_price( pkey );
+    } else if ( get_handle( jp_, vtok[0], hdl ) ) {
+      rec.px_ = hdl < sptr_->get_num_price() ?
+        sptr_->get_price( (uint32_t)hdl ) : nullptr;
+    } else {
+      rec.err_ = PC_JSON_INVALID_PARAMS;
+    }
+    rec.price_ = jp_.get_int( vtok[1] );
+    rec.conf_  = jp_.get_uint( vtok[2] );
+    rec.st_    = str_to_symbol_status( jp_.get_str( vtok[3] ) );
+    uvec_.push_back( rec );
+  }
+
+  // submit prices and acknowledge with [index, error] of failures
+  add_header();
+  jw_.add_key( "result", json_wtr::e_arr );
+  for( unsigned i=0; i != uvec_.size(); ++i ) {
+    upd_rec& rec = uvec_[i];
+    int err = 0;
+    if ( PC_UNLIKELY( rec.err_ ) ) {
+      err = rec.err_;
+    } else if ( PC_UNLIKELY( !rec.px_ ) ) {
+      err = PC_JSON_UNKNOWN_SYMBOL;
+    } else if ( !rec.px_->update( rec.price_, rec.conf_, rec.st_ ) ) {
+      err = get_upd_err( rec.px_ );
+    }
+    if ( err ) {
+      jw_.add_val( json_wtr::e_arr );
+      jw_.add_val( (uint64_t)i );
+      jw_.add_val( (int64_t)err );
+      jw_.pop();
+    }
+  }
+  jw_.pop();
+  add_tail( itok );
+}
+
 void user::parse_sub_price( uint32_t tok, uint32_t itok )
 {
   do {
     // unpack and verify parameters
-    uint32_t ntok,ptok = jp_.find_val( tok, "params" );
+    uint32_t ptok = jp_.find_val( tok, "params" );
     if ( ptok == 0 || jp_.get_type(ptok) != jtree::e_obj ) break;
-    if ( 0 == (ntok = jp_.find_val( ptok, "account" ) ) ) break;
-    pub_key pkey;
-    pkey.init_from_text( jp_.get_str( ntok ) );
-    price *sptr = sptr_->get_price( pkey );
+    price *sptr;
+    if ( !find_price( ptok, sptr ) ) break;
     if ( PC_UNLIKELY( !sptr ) ) { add_unknown_symbol(itok); return; }
 
+    // optional maximum number of notifications per second
+    int64_t ival = 0;
+    uint32_t rtok = jp_.find_val( ptok, "max_rate" );
+    if ( rtok ) {
+      uint64_t rate = jp_.get_uint( rtok );
+      ival = rate ? PC_NSECS_IN_SEC / (int64_t)rate : 0L;
+    }
+
     // add subscription
     uint64_t sub_id = psub_.add( sptr );
+    set_sub( sub_id, sptr, false, ival );
 
     // create result
     add_header();
@@ -239,12 +393,10 @@ void user::parse_sub_price_sched( uint32_t tok, uint32_t itok )
 {
   do {
     // unpack and verify parameters
-    uint32_t ntok,ptok = jp_.find_val( tok, "params" );
+    uint32_t ptok = jp_.find_val( tok, "params" );
     if ( ptok == 0 || jp_.get_type(ptok) != jtree::e_obj ) break;
-    if ( 0 == (ntok = jp_.find_val( ptok, "account" ) ) ) break;
-    pub_key pkey;
-    pkey.init_from_text( jp_.get_str( ntok ) );
-    price *sptr = sptr_->get_price( pkey );
+    price *sptr;
+    if ( !find_price( ptok, sptr ) ) break;
     if ( PC_UNLIKELY( !sptr ) ) { add_unknown_symbol(itok); return; }
 
     // add subscription
@@ -264,28 +416,15 @@ void user::parse_sub_price_sched( uint32_t tok, uint32_t itok )
 void user::parse_get_product_list( uint32_t itok )
 {
   add_header();
-  jw_.add_key( "result", json_wtr::e_arr );
-  for( unsigned i=0; i != sptr_->get_num_product(); ++i ) {
-    product *prod = sptr_->get_product( i );
-    jw_.add_val( json_wtr::e_obj );
-    jw_.add_key( "account", *prod->get_account() );
-    jw_.add_key( "attr_dict", json_wtr::e_obj );
-    prod->write_json( jw_ );
-    jw_.pop();
-    jw_.add_key( "price", json_wtr::e_arr );
-    for( unsigned j=0; j != prod->get_num_price(); ++j ) {
-      jw_.add_val( json_wtr::e_obj );
-      price *px = prod->get_price( j );
-      int64_t expo = px->get_price_exponent();
-      price_type ptype = px->get_price_type();
-      jw_.add_key( "account", *px->get_account() );
-      jw_.add_key( "price_exponent", expo );
-      jw_.add_key( "price_type", price_type_to_str( ptype) );
-      jw_.pop();
-    }
-    jw_.pop();
-    jw_.pop();
-  }
+  jw_.add_key_verbatim( "result", sptr_->get_product_list() );
+  add_tail( itok );
+}
+
+void user::parse_get_product_list_version( uint32_t itok )
+{
+  add_header();
+  jw_.add_key( "result", json_wtr::e_obj );
+  jw_.add_key( "version", sptr_->get_product_list_version() );
   jw_.pop();
   add_tail( itok );
 }
@@ -346,6 +485,36 @@ void user::add_error( uint32_t id, int err, str emsg )
 
 void user::on_response( price *rptr, uint64_t idx )
 {
+  // defer notification while send queue is backed up or subscription is
+  // rate limited. a pending notification sends the latest price when due
+  if ( PC_UNLIKELY( idx >= svec_.size() ) ) {
+    return;
+  }
+  sub_rec& sub = svec_[idx];
+  if ( sub.is_pend_ ) {
+    ++nconf_;
+    return;
+  }
+  if ( get_is_slow() ||
+       ( sub.ival_ && sptr_->get_curr_time() - sub.ts_ < sub.ival_ ) ) {
+    sub.is_pend_ = true;
+    pvec_.push_back( idx );
+    return;
+  }
+  add_notify( rptr, idx );
+}
+
+void user::add_notify( price *rptr, uint64_t idx )
+{
+  sub_rec& sub = svec_[idx];
+  sub.ts_ = sptr_->get_curr_time();
+
+  // batch binary api notifications until next flush
+  if ( sub.is_bin_ ) {
+    add_bin_notify( rptr );
+    return;
+  }
+
   // construct notify response
   jw_.reset();
   add_header();
@@ -371,6 +540,46 @@ void user::on_response( price *rptr, uint64_t idx )
   add_send( msg );
 }
 
+bool user::get_is_slow()
+{
+  // hysteresis between high and low send queue watermarks
+  size_t sz = get_send_size() + bw_.size();
+  if ( PC_UNLIKELY( !is_slow_ && sz > hwm_ ) ) {
+    is_slow_ = true;
+    PC_LOG_INF( "user_slow" )
+      .add( "fd", get_fd() )
+      .add( "send_size", sz )
+      .end();
+  } else if ( is_slow_ && sz <= lwm_ ) {
+    is_slow_ = false;
+    PC_LOG_INF( "user_caught_up" )
+      .add( "fd", get_fd() )
+      .add( "num_pending", pvec_.size() )
+      .add( "num_conflated", nconf_ )
+      .end();
+  }
+  return is_slow_;
+}
+
+void user::flush_pending()
+{
+  if ( pvec_.empty() || get_is_slow() ) {
+    return;
+  }
+  int64_t now = sptr_->get_curr_time();
+  size_t num = 0;
+  for( uint64_t idx: pvec_ ) {
+    sub_rec& sub = svec_[idx];
+    if ( sub.ival_ && now - sub.ts_ < sub.ival_ ) {
+      pvec_[num++] = idx;
+      continue;
+    }
+    sub.is_pend_ = false;
+    add_notify( sub.px_, idx );
+  }
+  pvec_.resize( num );
+}
+
 void user::on_response( price_sched *, uint64_t idx )
 {
   // construct notify response
@@ -387,3 +596,158 @@ void user::on_response( price_sched *, uint64_t idx )
   msg.commit( ws_wtr::text_id, jw_, false );
   add_send( msg );
 }
+
+///////////////////////////////////////////////////////////////////////////
+// binary api
+
+bool user::accept_protocol( str prot )
+{
+  if ( prot == str( PC_BIN_PROTOCOL ) ) {
+    has_bin_ = true;
+    return true;
+  }
+  return false;
+}
+
+void user::set_sub(
+    uint64_t sub_id, price *sptr, bool is_bin, int64_t ival )
+{
+  if ( sub_id >= svec_.size() ) {
+    svec_.resize( sub_id + 1 );
+  }
+  sub_rec& sub = svec_[sub_id];
+  sub.px_      = sptr;
+  sub.ival_    = ival;
+  sub.ts_      = 0L;
+  sub.is_bin_  = is_bin;
+  sub.is_pend_ = false;
+}
+
+void user::parse_bin_msg( const char *buf, size_t len )
+{
+  // binary frames are json unless binary api was negotiated
+  if ( !has_bin_ ) {
+    parse_msg( buf, len );
+    return;
+  }
+  const char *end = &buf[len];
+  while( buf != end ) {
+    bin::hdr hdr = bin::hdr();
+    size_t rlen = 0;
+    if ( (size_t)( end - buf ) >= sizeof( hdr ) ) {
+      __builtin_memcpy( &hdr, buf, sizeof( hdr ) );
+      buf += sizeof( hdr );
+      switch( hdr.type_ ) {
+        case bin::e_resolve:   rlen = sizeof( bin::resolve ); break;
+        case bin::e_upd_price: rlen = sizeof( bin::upd_price ); break;
+        case bin::e_sub_price: rlen = sizeof( bin::sub_price ); break;
+        default: break;
+      }
+    }
+    if ( !rlen || (size_t)( end - buf ) < rlen * hdr.num_ ) {
+      // malformed batch - ignore rest of frame
+      bw_.add_hdr( bin::e_error, hdr.id_ );
+      break;
+    }
+    switch( hdr.type_ ) {
+      case bin::e_resolve:   parse_bin_resolve( hdr, buf ); break;
+      case bin::e_upd_price: parse_bin_upd_price( hdr, buf ); break;
+      case bin::e_sub_price: parse_bin_sub_price( hdr, buf ); break;
+    }
+    buf += rlen * hdr.num_;
+  }
+  flush_bin();
+}
+
+void user::parse_bin_resolve( const bin::hdr& hdr, const char *buf )
+{
+  const bin::resolve *rec = (const bin::resolve*)buf;
+  bw_.add_hdr( bin::e_resolve_res, hdr.id_ );
+  for( unsigned i=0; i != hdr.num_; ++i ) {
+    pub_key pkey;
+    pkey.init_from_buf( rec[i].acc_ );
+    price *sptr = sptr_->get_price( pkey );
+    bin::resolve_res res;
+    res.handle_ = sptr ? sptr->get_handle() : bin::unknown_handle;
+    res.expo_   = sptr ? (int32_t)sptr->get_price_exponent() : 0;
+    bw_.add_rec( res );
+  }
+}
+
+void user::parse_bin_upd_price( const bin::hdr& hdr, const char *buf )
+{
+  // acknowledge batch listing only the failed updates
+  const bin::upd_price *rec = (const bin::upd_price*)buf;
+  bw_.add_hdr( bin::e_upd_price_res, hdr.id_ );
+  for( unsigned i=0; i != hdr.num_; ++i ) {
+    bin::upd_price_res res;
+    res.idx_ = i;
+    price *sptr = sptr_->get_price( rec[i].handle_ );
+    if ( !sptr ) {
+      res.err_ = PC_JSON_UNKNOWN_SYMBOL;
+    } else if ( rec[i].status_ >=
+                (uint32_t)symbol_status::e_last_symbol_status ) {
+      res.err_ = PC_JSON_INVALID_PARAMS;
+    } else if ( sptr->update( rec[i].price_, rec[i].conf_,
+                              (symbol_status)rec[i].status_ ) ) {
+      continue;
+    } else {
+      res.err_ = get_upd_err( sptr );
+    }
+    bw_.add_rec( res );
+  }
+}
+
+void user::parse_bin_sub_price( const bin::hdr& hdr, const char *buf )
+{
+  // acknowledge subscriptions then send current prices
+  const bin::sub_price *rec = (const bin::sub_price*)buf;
+  bw_.add_hdr( bin::e_sub_price_res, hdr.id_ );
+  for( unsigned i=0; i != hdr.num_; ++i ) {
+    bin::sub_price_res res;
+    res.handle_ = rec[i].handle_;
+    res.err_    = 0;
+    price *sptr = sptr_->get_price( rec[i].handle_ );
+    if ( sptr ) {
+      set_sub( psub_.add( sptr ), sptr, true, 0L );
+    } else {
+      res.err_ = PC_JSON_UNKNOWN_SYMBOL;
+    }
+    bw_.add_rec( res );
+  }
+  for( unsigned i=0; i != hdr.num_; ++i ) {
+    price *sptr = sptr_->get_price( rec[i].handle_ );
+    if ( sptr ) {
+      add_bin_notify( sptr );
+    }
+  }
+}
+
+void user::add_bin_notify( price *rptr )
+{
+  if ( bw_.get_type() != bin::e_notify_price ) {
+    bw_.add_hdr( bin::e_notify_price, 0 );
+  }
+  bin::notify_price res;
+  res.handle_     = rptr->get_handle();
+  res.status_     = (uint32_t)rptr->get_status();
+  res.price_      = rptr->get_price();
+  res.conf_       = rptr->get_conf();
+  res.twap_       = rptr->get_twap();
+  res.twac_       = rptr->get_twac();
+  res.valid_slot_ = rptr->get_valid_slot();
+  res.pub_slot_   = rptr->get_pub_slot();
+  res.num_qt_     = rptr->get_num_qt();
+  res.unused_     = 0;
+  bw_.add_rec( res );
+}
+
+void user::flush_bin()
+{
+  if ( bw_.size() ) {
+    ws_wtr msg;
+    msg.commit( ws_wtr::binary_id, bw_, false );
+    add_send( msg );
+    bw_.reset();
+  }
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <pc/net_socket.hpp>
+#include <pc/user_bin.hpp>
 #include <pc/rpc_client.hpp>
 #include <pc/request.hpp>
 #include <pc/key_store.hpp>
@@ -33,6 +34,24 @@ namespace pc
 
     // websocket message parsing
     void parse_msg( const char *buf, size_t sz ) override;
+    void parse_bin_msg( const char *buf, size_t sz ) override;
+
+    // negotiate binary api subprotocol
+    bool accept_protocol( str ) override;
+
+    // send batched binary api notifications
+    void flush_bin();
+
+    // send queue watermarks in bytes. above the high watermark only the
+    // latest pending update per subscription is kept until the queue
+    // drains below the low watermark (default 1MB and 256KB)
+    void set_send_watermarks( size_t high, size_t low );
+
+    // send conflated and rate-limited price notifications now due
+    void flush_pending();
+
+    // price notifications superseded before they could be sent
+    uint64_t get_num_conflated() const;
 
     // manager disconnected
     void teardown() override;
@@ -56,11 +75,34 @@ namespace pc
       uint64_t sid_;
     };
 
+    struct upd_rec {
+      price        *px_;
+      int64_t       price_;
+      uint64_t      conf_;
+      symbol_status st_;
+      int           err_;
+    };
+
+    // per-subscription notification state
+    struct sub_rec {
+      price   *px_;       // subscribed price
+      int64_t  ival_;     // minimum notification interval (or zero)
+      int64_t  ts_;       // last notification time
+      bool     is_bin_;   // binary api subscription
+      bool     is_pend_;  // notification pending
+    };
+
     typedef std::vector<deferred_sub> def_vec_t;
+    typedef std::vector<upd_rec>      upd_vec_t;
+    typedef std::vector<sub_rec>      sub_vec_t;
+    typedef std::vector<uint64_t>     pend_vec_t;
 
     void parse_request( uint32_t );
+    bool find_price( uint32_t, price *& );
     void parse_get_product_list( uint32_t );
+    void parse_get_product_list_version( uint32_t );
     void parse_upd_price( uint32_t,  uint32_t );
+    void parse_upd_prices( uint32_t,  uint32_t );
     void parse_sub_price( uint32_t,  uint32_t );
     void parse_sub_price_sched( uint32_t,  uint32_t );
     void add_header();
@@ -70,6 +112,13 @@ namespace pc
     void add_invalid_params( uint32_t id );
     void add_unknown_symbol( uint32_t id );
     void add_error( uint32_t id, int err, str );
+    void parse_bin_resolve( const bin::hdr&, const char * );
+    void parse_bin_upd_price( const bin::hdr&, const char * );
+    void parse_bin_sub_price( const bin::hdr&, const char * );
+    void add_bin_notify( price * );
+    void add_notify( price *, uint64_t sub_id );
+    void set_sub( uint64_t sub_id, price *, bool is_bin, int64_t ival );
+    bool get_is_slow();
 
     rpc_client     *rptr_;    // rpc manager api
     manager        *sptr_;    // manager collection
@@ -77,7 +126,16 @@ namespace pc
     jtree           jp_;      // json parser
     json_wtr        jw_;      // json writer
     def_vec_t       dvec_;    // deferred subscriptions
+    upd_vec_t       uvec_;    // batched price updates
     request_sub_set psub_;    // price subscriptions
+    bin_wtr         bw_;      // binary api writer
+    sub_vec_t       svec_;    // price subscription state
+    pend_vec_t      pvec_;    // subscriptions with pending notification
+    size_t          hwm_;     // send queue high watermark
+    size_t          lwm_;     // send queue low watermark
+    uint64_t        nconf_;   // number of conflated notifications
+    bool            is_slow_; // send queue above watermark
+    bool            has_bin_; // binary api negotiated
   };
 
 }
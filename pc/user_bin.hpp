@@ -0,0 +1,147 @@
+#pragma once
+
+#include <pc/net_socket.hpp>
+
+// websocket subprotocol name of binary pythd user api
+#define PC_BIN_PROTOCOL "pyth-bin-v1"
+
+namespace pc
+{
+
+  // binary pythd user api. each binary websocket frame holds one or more
+  // batches; a batch is a hdr followed by num_ fixed-layout records of
+  // the type given in the header. all fields are little-endian and
+  // prices are addressed by the handle returned from a resolve request
+  namespace bin
+  {
+    // batch types
+    enum : uint16_t {
+      e_resolve         = 1,      // account keys to price handles
+      e_upd_price       = 2,      // publish component prices
+      e_sub_price       = 3,      // subscribe to aggregate prices
+      e_resolve_res     = 0x8001, // one resolve_res per resolve
+      e_upd_price_res   = 0x8002, // one upd_price_res per failed update
+      e_sub_price_res   = 0x8003, // one sub_price_res per subscription
+      e_notify_price    = 0x8004, // aggregate price updates
+      e_error           = 0x80ff  // malformed batch (num_ is zero)
+    };
+
+    // handle of unknown account
+    static const uint32_t unknown_handle = (uint32_t)-1;
+
+    struct hdr
+    {
+      uint16_t type_;         // batch type
+      uint16_t num_;          // number of records
+      uint32_t id_;           // request id echoed back in response
+    } PC_PACKED;
+
+    struct resolve
+    {
+      uint8_t  acc_[32];      // price account key
+    } PC_PACKED;
+
+    struct resolve_res
+    {
+      uint32_t handle_;       // price handle or unknown_handle
+      int32_t  expo_;         // price exponent
+    } PC_PACKED;
+
+    struct upd_price
+    {
+      uint32_t handle_;       // price handle
+      uint32_t status_;       // symbol_status
+      int64_t  price_;        // price in units of exponent
+      uint64_t conf_;         // confidence interval
+    } PC_PACKED;
+
+    struct upd_price_res
+    {
+      uint32_t idx_;          // index of failed record in batch
+      int32_t  err_;          // json-rpc error code
+    } PC_PACKED;
+
+    struct sub_price
+    {
+      uint32_t handle_;       // price handle
+    } PC_PACKED;
+
+    struct sub_price_res
+    {
+      uint32_t handle_;       // price handle
+      int32_t  err_;          // zero or json-rpc error code
+    } PC_PACKED;
+
+    struct notify_price
+    {
+      uint32_t handle_;       // price handle
+      uint32_t status_;       // aggregate symbol_status
+      int64_t  price_;        // aggregate price
+      uint64_t conf_;         // aggregate confidence interval
+      int64_t  twap_;         // time-weighted average price
+      uint64_t twac_;         // time-weighted average confidence
+      uint64_t valid_slot_;   // slot of previous aggregate update
+      uint64_t pub_slot_;     // publish slot of aggregate
+      uint32_t num_qt_;       // number of quoters in aggregate
+      uint32_t unused_;
+    } PC_PACKED;
+  }
+
+  // writer of binary api batches
+  class bin_wtr : public net_wtr
+  {
+  public:
+    bin_wtr();
+
+    // start new batch
+    void add_hdr( uint16_t type, uint32_t id );
+
+    // add record to current batch or continuation batch if full
+    template<class T> void add_rec( const T& );
+
+    // type of current batch (or zero)
+    uint16_t get_type() const;
+
+    void reset();
+
+  private:
+    bin::hdr *hdr_;
+  };
+
+  inline bin_wtr::bin_wtr()
+  : hdr_( nullptr )
+  {
+  }
+
+  inline void bin_wtr::add_hdr( uint16_t type, uint32_t id )
+  {
+    hdr_ = (bin::hdr*)reserve( sizeof( bin::hdr ) );
+    hdr_->type_ = type;
+    hdr_->num_  = 0;
+    hdr_->id_   = id;
+    advance( sizeof( bin::hdr ) );
+  }
+
+  template<class T>
+  void bin_wtr::add_rec( const T& rec )
+  {
+    if ( hdr_->num_ == (uint16_t)-1 ) {
+      add_hdr( hdr_->type_, hdr_->id_ );
+    }
+    ++hdr_->num_;
+    __builtin_memcpy( reserve( sizeof( T ) ), &rec, sizeof( T ) );
+    advance( sizeof( T ) );
+  }
+
+  inline uint16_t bin_wtr::get_type() const
+  {
+    return hdr_ ? hdr_->type_ : 0;
+  }
+
+  inline void bin_wtr::reset()
+  {
+    net_wtr::reset();
+    hdr_ = nullptr;
+  }
+
+}
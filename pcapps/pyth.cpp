@@ -26,6 +26,16 @@ std::string get_key_store()
 
 using namespace pc;
 
+int get_num_in_flight()
+{
+  return 16;
+}
+
+int get_num_http_conn()
+{
+  return 4;
+}
+
 int usage()
 {
   std::cerr << "usage: pyth " << std::endl;
@@ -53,6 +63,10 @@ int usage()
             << std::endl;
   std::cerr << "  get_balance      [<pub_key>] [options]" << std::endl;
   std::cerr << "  get_block        <slot_number> [options]" << std::endl;
+  std::cerr << "  get_block_range  <first_slot> <last_slot> "
+            << "[-n <num_in_flight (default " << get_num_in_flight()
+            << ")>] [-m <num_http_conn (default " << get_num_http_conn()
+            << ")>] [options]" << std::endl;
   std::cerr << "  get_product      <prod_key> [options]" << std::endl;
   std::cerr << "  get_product_list [options]" << std::endl;
   std::cerr << "  get_pub_key      <key_pair_file>" << std::endl;
@@ -572,9 +586,7 @@ int on_add_price( int argc, char **argv )
   if ( do_prompt ) {
     std::cout << "adding new price account:" << std::endl;
     print( "product account", 2 );
-    pub_key pacc( *prod->get_account() );
-    pacc.enc_base58( pkey );
-    std::cout << pkey << std::endl;
+    std::cout << prod->get_account()->get_text().as_string() << std::endl;
     print( "symbol", 2 );
     std::cout << prod->get_symbol().as_string() << std::endl;
     print( "price_type", 2 );
@@ -671,9 +683,7 @@ int on_init_price( int argc, char **argv )
   if ( do_prompt ) {
     std::cout << "initialize price account:" << std::endl;
     print( "price account", 2 );
-    pub_key pacc( *px->get_account() );
-    pacc.enc_base58( pkey );
-    std::cout << pkey << std::endl;
+    std::cout << px->get_account()->get_text().as_string() << std::endl;
     print( "symbol", 2 );
     std::cout << px->get_symbol().as_string() << std::endl;
     print( "price_type", 2 );
@@ -1013,20 +1023,18 @@ int on_get_product_list( int argc, char **argv )
   }
   // list key/symbol pairs
   if ( !do_json ) {
-    std::string astr;
     std::cout << "account,symbol" << std::endl;
     for(unsigned i=0; i != mgr.get_num_product(); ++i ) {
       product *prod = mgr.get_product(i);
-      pub_key *akey = prod->get_account();
-      akey->enc_base58( astr );
-      std::cout << astr << ',' << prod->get_symbol().as_string()<< std::endl;
+      std::cout << prod->get_account()->get_text().as_string() << ','
+                << prod->get_symbol().as_string()<< std::endl;
     }
   } else {
     json_wtr wtr;
     wtr.add_val( json_wtr::e_arr );
     for(unsigned i=0; i != mgr.get_num_product(); ++i ) {
       product *prod = mgr.get_product(i);
-      pub_key *akey = prod->get_account();
+      pub_key_b58 *akey = prod->get_account();
       wtr.add_val( json_wtr::e_obj );
       wtr.add_key( "account", *akey );
       wtr.add_key( "symbol", prod->get_symbol() );
@@ -1040,12 +1048,9 @@ int on_get_product_list( int argc, char **argv )
 
 static void print_product( product *prod )
 {
-  std::string pkey;
   std::cout << "product details:" << std::endl;
   print( "product account", 2 );
-  pub_key pacc( *prod->get_account() );
-  pacc.enc_base58( pkey );
-  std::cout << pkey << std::endl;
+  std::cout << prod->get_account()->get_text().as_string() << std::endl;
   print( "num_price", 2 );
   std::cout << prod->get_num_price() << std::endl;
   str vstr, kstr;
@@ -1063,9 +1068,7 @@ static void print_product( product *prod )
     std::string ikey;
     price *ptr = prod->get_price( i );
     print( "price account", 2 );
-    pub_key pacc( *ptr->get_account() );
-    pacc.enc_base58( ikey );
-    std::cout << ikey << std::endl;
+    std::cout << ptr->get_account()->get_text().as_string() << std::endl;
     print( "price_type", 4 );
     std::cout << price_type_to_str( ptr->get_price_type() ).as_string()
               << std::endl;
@@ -1226,12 +1229,12 @@ public:
     std::string kstr;
     std::cout << "upd_price:" << std::endl;
     print( "publisher", 2 );
-    res->get_key( 0 )->enc_base58( kstr );
+    res->get_ins_key( 0 )->enc_base58( kstr );
     std::cout << kstr << std::endl;
     print( "price_account", 2 );
-    res->get_key( 1 )->enc_base58( kstr );
+    res->get_ins_key( 1 )->enc_base58( kstr );
     std::cout << kstr << std::endl;
-    price *px = mgr_->get_price( *res->get_key(1) );
+    price *px = mgr_->get_price( *res->get_ins_key(1) );
     if ( px ) {
       print( "symbol", 2 );
       std::cout << px->get_symbol().as_string() << std::endl;
@@ -1266,6 +1269,9 @@ public:
     }
     char *cbuf = res->get_cmd();
     cmd_hdr *hdr = (cmd_hdr*)cbuf;
+    if ( res->get_num_ins_key() < 3 ) {
+      return;
+    }
     switch( hdr->cmd_ ) {
       case e_cmd_upd_price: on_upd_price( res ); break;
     }
@@ -1281,10 +1287,10 @@ public:
   void on_upd_price( rpc::get_block *res ) {
     wtr_.add_val( json_wtr::e_obj );
     wtr_.add_key( "event", "upd_price" );
-    wtr_.add_key( "publisher", *res->get_key( 0 ) );
-    wtr_.add_key( "price_account", *res->get_key( 1 ) );
-    wtr_.add_key( "param_account", *res->get_key( 2 ) );
-    price *px = mgr_->get_price( *res->get_key(1) );
+    wtr_.add_key( "publisher", *res->get_ins_key( 0 ) );
+    wtr_.add_key( "price_account", *res->get_ins_key( 1 ) );
+    wtr_.add_key( "param_account", *res->get_ins_key( 2 ) );
+    price *px = mgr_->get_price( *res->get_ins_key(1) );
     if ( px ) {
       wtr_.add_key( "symbol", px->get_symbol() );
     }
@@ -1312,6 +1318,9 @@ public:
     }
     char *cbuf = res->get_cmd();
     cmd_hdr *hdr = (cmd_hdr*)cbuf;
+    if ( res->get_num_ins_key() < 3 ) {
+      return;
+    }
     switch( hdr->cmd_ ) {
       case e_cmd_upd_price: on_upd_price( res ); break;
     }
@@ -1385,6 +1394,216 @@ int on_get_block( int argc, char **argv )
   return ret;
 }
 
+// streams pyth price updates of one block at a time as csv or
+// json lines and reports skipped slots as empty
+class get_block_scan : public get_block
+{
+public:
+  get_block_scan( manager *mgr, bool do_json )
+  : mgr_( mgr ), do_json_( do_json ), num_blk_( 0 ), num_skip_( 0 ),
+    num_upd_( 0 ) {
+  }
+  void set_slot( uint64_t slot ) {
+    get_block::set_slot( slot );
+    st_ = e_sent;
+  }
+  void on_upd_price( rpc::get_block *res ) {
+    ++num_upd_;
+    cmd_upd_price *cmd = (cmd_upd_price*)res->get_cmd();
+    price *px = mgr_->get_price( *res->get_ins_key(1) );
+    str sym = px ? px->get_symbol() : str();
+    str status = symbol_status_to_str( (symbol_status)cmd->status_ );
+    str tx_err = res->get_is_tx_err() ? res->get_tx_err() : str();
+    if ( do_json_ ) {
+      json_wtr wtr;
+      wtr.add_val( json_wtr::e_obj );
+      wtr.add_key( "slot", res->get_slot() );
+      wtr.add_key( "publisher", *res->get_ins_key( 0 ) );
+      wtr.add_key( "price_account", *res->get_ins_key( 1 ) );
+      wtr.add_key( "symbol", sym );
+      wtr.add_key( "status", status );
+      wtr.add_key( "price", cmd->price_ );
+      wtr.add_key( "conf", cmd->conf_ );
+      wtr.add_key( "pub_slot", cmd->pub_slot_ );
+      wtr.add_key( "tx_fee", res->get_tx_fee() );
+      if ( res->get_is_tx_err() ) {
+        wtr.add_key( "tx_error", tx_err );
+      }
+      wtr.pop();
+      print_json( wtr );
+      std::cout << '\n';
+    } else {
+      std::string pkey, akey;
+      res->get_ins_key( 0 )->enc_base58( pkey );
+      res->get_ins_key( 1 )->enc_base58( akey );
+      std::cout << res->get_slot() << ','
+                << pkey << ','
+                << akey << ','
+                << sym.as_string() << ','
+                << status.as_string() << ','
+                << cmd->price_ << ','
+                << cmd->conf_ << ','
+                << cmd->pub_slot_ << ','
+                << res->get_tx_fee() << ','
+                << tx_err.as_string() << '\n';
+    }
+  }
+  void on_response( rpc::get_block *res ) override {
+    if ( res->get_is_err() ) {
+      switch( res->get_err_code() ) {
+        case PC_RPC_ERROR_SLOT_SKIPPED:
+        case PC_RPC_ERROR_LONG_TERM_SLOT_SKIPPED:
+        case PC_RPC_ERROR_BLOCK_NOT_AVAILABLE:
+        case PC_RPC_ERROR_BLOCK_CLEANED_UP:
+          ++num_skip_;
+          res->reset_err();
+          st_ = e_done;
+          return;
+        default:
+          on_error_sub( res->get_err_msg(), this );
+          st_ = e_error;
+          return;
+      }
+    }
+    if ( res->get_is_end() ) {
+      ++num_blk_;
+      st_ = e_done;
+      return;
+    }
+    cmd_hdr *hdr = (cmd_hdr*)res->get_cmd();
+    if ( res->get_num_ins_key() < 3 ) {
+      return;
+    }
+    switch( hdr->cmd_ ) {
+      case e_cmd_upd_price: on_upd_price( res ); break;
+    }
+  }
+  manager *mgr_;
+  bool     do_json_;
+  uint64_t num_blk_;
+  uint64_t num_skip_;
+  uint64_t num_upd_;
+};
+
+int on_get_block_range( int argc, char **argv )
+{
+  if ( argc < 3 ) {
+    return usage();
+  }
+  uint64_t first_slot = ::atol( argv[1] );
+  uint64_t last_slot  = ::atol( argv[2] );
+  if ( first_slot == 0 || last_slot < first_slot ) {
+    std::cerr << "pyth: invalid slot range=" << argv[1] << ','
+              << argv[2] << std::endl;
+    return 1;
+  }
+  argc -= 2;
+  argv += 2;
+
+  int opt = 0, num_req = get_num_in_flight();
+  int num_conn = get_num_http_conn();
+  bool do_json = false;
+  commitment cmt = commitment::e_finalized;
+  std::string rpc_host = get_rpc_host();
+  std::string key_dir  = get_key_store();
+  while( (opt = ::getopt(argc,argv, "r:k:c:n:m:djh" )) != -1 ) {
+    switch(opt) {
+      case 'r': rpc_host = optarg; break;
+      case 'k': key_dir = optarg; break;
+      case 'd': log::set_level( PC_LOG_DBG_LVL ); break;
+      case 'j': do_json = true; break;
+      case 'c': cmt = str_to_commitment(optarg); break;
+      case 'n': num_req = ::atoi(optarg); break;
+      case 'm': num_conn = ::atoi(optarg); break;
+      default: return usage();
+    }
+  }
+  if ( cmt == commitment::e_unknown ) {
+    std::cerr << "pyth: unknown commitment level" << std::endl;
+    return usage();
+  }
+  if ( num_req <= 0 || num_conn <= 0 ) {
+    std::cerr << "pyth: invalid number of requests or connections"
+              << std::endl;
+    return usage();
+  }
+
+  // initialize pool of connections to block-chain
+  manager mgr;
+  mgr.set_num_http_conn( num_conn );
+  mgr.set_rpc_host( rpc_host );
+  mgr.set_dir( key_dir );
+  mgr.set_do_tx( false );
+  mgr.set_commitment( cmt );
+  if ( !mgr.init() || !mgr.bootstrap() ) {
+    std::cerr << "pyth: " << mgr.get_err_msg() << std::endl;
+    return 1;
+  }
+  if ( !do_json ) {
+    std::cout << "slot,publisher,price_account,symbol,status,price,conf,"
+                 "pub_slot,tx_fee,tx_error\n";
+  }
+
+  // keep num_req block requests in flight across the connection pool
+  // and resubmit each one with the next slot as soon as it completes
+  std::vector<get_block_scan*> rvec;
+  uint64_t slot = first_slot;
+  for( int i = 0; i != num_req && slot <= last_slot; ++i ) {
+    get_block_scan *req = new get_block_scan( &mgr, do_json );
+    req->set_commitment( cmt );
+    req->set_slot( slot++ );
+    mgr.submit( req );
+    rvec.push_back( req );
+  }
+  int ret = 0;
+  while( !ret && !mgr.get_is_err() ) {
+    bool is_busy = false;
+    for( get_block_scan *req: rvec ) {
+      if ( req->get_is_err() ) {
+        std::cerr << "pyth: " << req->get_err_msg() << std::endl;
+        ret = 1;
+        break;
+      }
+      if ( !req->get_is_done() ) {
+        is_busy = true;
+      } else if ( slot <= last_slot ) {
+        req->set_slot( slot++ );
+        mgr.submit( req );
+        is_busy = true;
+      }
+    }
+    if ( !is_busy ) {
+      break;
+    }
+    mgr.poll();
+  }
+  if ( mgr.get_is_err() ) {
+    std::cerr << "pyth: " << mgr.get_err_msg() << std::endl;
+    ret = 1;
+  }
+
+  // summary of scanned range
+  uint64_t num_blk = 0, num_skip = 0, num_upd = 0;
+  for( get_block_scan *req: rvec ) {
+    num_blk  += req->num_blk_;
+    num_skip += req->num_skip_;
+    num_upd  += req->num_upd_;
+    delete req;
+  }
+  std::cout.flush();
+  std::cerr << "pyth: num_block=" << num_blk
+            << " num_skipped=" << num_skip
+            << " num_upd_price=" << num_upd << std::endl;
+  rpc_client *clnt = mgr.get_rpc_client();
+  for( unsigned i = 0; i != clnt->get_num_http_conn(); ++i ) {
+    std::cerr << "pyth: http_conn=" << i
+              << " num_req=" << clnt->get_http_num_req( i )
+              << " latency_ms=" << 1e-6*clnt->get_http_latency( i )
+              << std::endl;
+  }
+  return ret;
+}
+
 int main(int argc, char **argv)
 {
   if ( argc < 2 ) {
@@ -1436,6 +1655,8 @@ int main(int argc, char **argv)
     rc = on_get_product_list( argc, argv );
   } else if ( cmd == "get_block" ) {
     rc = on_get_block( argc, argv );
+  } else if ( cmd == "get_block_range" ) {
+    rc = on_get_block_range( argc, argv );
   } else if ( cmd == "version" ) {
     std::cout << "version: " << PC_VERSION << std::endl;
   } else {
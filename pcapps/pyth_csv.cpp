@@ -1,9 +1,18 @@
+// per-thread heap area for aggregation scratch space
+static thread_local unsigned long agg_heap[1024];
+#define PC_HEAP_START ((char*)agg_heap)
+
 #include <pc/replay.hpp>
 #include <pc/rpc_client.hpp>
 #include <pc/misc.hpp>
 #include <unistd.h>
 #include <signal.h>
 #include <iostream>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <oracle/upd_aggregate.h>
 
 using namespace pc;
 
@@ -23,6 +32,15 @@ public:
   // parse next update
   void parse( replay& );
 
+  // format price account as csv row
+  void format_price( pc_price_t *, int64_t ts, std::string& );
+
+  // check if price account passes symbol filter
+  bool has_price( pc_price_t * );
+
+  // check if account is a product account and register its symbol
+  bool parse_product_only( replay& );
+
 private:
 
   struct trait_account {
@@ -116,50 +134,94 @@ void csv_print::parse_product( replay& rep )
   }
 }
 
-void csv_print::parse_price( replay& rep )
+bool csv_print::has_price( pc_price_t *ptr )
+{
+  pub_key *aptr = (pub_key*)&ptr->prod_;
+  return !do_sym_ || ( has_sym_ && *aptr == skey_ );
+}
+
+static void add_int( std::string& out, int64_t val )
+{
+  char buf[32], *end = &buf[sizeof(buf)];
+  char *ptr = int_to_str( val, end );
+  out.append( ptr, end - ptr );
+}
+
+static void add_uint( std::string& out, uint64_t val )
+{
+  char buf[32], *end = &buf[sizeof(buf)];
+  char *ptr = uint_to_str( val, end );
+  out.append( ptr, end - ptr );
+}
+
+static void add_str( std::string& out, str val )
+{
+  out.append( val.str_, val.len_ );
+}
+
+void csv_print::format_price(
+    pc_price_t *ptr, int64_t ts, std::string& out )
 {
-  pc_price_t *ptr = (pc_price_t*)rep.get_update();
   pub_key *aptr = (pub_key*)&ptr->prod_;
-  // filter by symbol
-  if ( do_sym_ && (!has_sym_ || *aptr != skey_ ) ) {
-    return;
-  }
   char tbuf[32];
-  nsecs_to_utc6( rep.get_time(), tbuf );
-  std::cout.write( tbuf, 27 );
-  std::cout << ',';
+  nsecs_to_utc6( ts, tbuf );
+  out.append( tbuf, 27 );
+  out += ',';
   symbol_map_t::iter_t i = smap_.find( *aptr );
-  if ( i ) std::cout << smap_.obj(i);
-  std::cout << ',';
-  str pstr = price_type_to_str( (price_type)ptr->ptype_ );
-  std::cout.write( pstr.str_, pstr.len_ );
-  std::cout << ',' << ptr->expo_;
-  std::cout << ',';
-  str sstr = symbol_status_to_str( (symbol_status)ptr->agg_.status_ );
-  std::cout.write( sstr.str_, sstr.len_ );
-  std::cout << ',' << ptr->agg_.price_
-            << ',' << ptr->agg_.conf_
-            << ',' << ptr->twap_.val_
-            << ',' << ptr->twac_.val_
-            << ',' << ptr->num_qt_
-            << ',' << ptr->valid_slot_
-            << ',' << ptr->agg_.pub_slot_
-            << ',' << ptr->prev_slot_
-            << ',' << ptr->prev_price_
-            << ',' << ptr->prev_conf_;
+  if ( i ) out += smap_.obj(i);
+  out += ',';
+  add_str( out, price_type_to_str( (price_type)ptr->ptype_ ) );
+  out += ',';
+  add_int( out, ptr->expo_ );
+  out += ',';
+  add_str( out, symbol_status_to_str( (symbol_status)ptr->agg_.status_ ) );
+  out += ',';
+  add_int( out, ptr->agg_.price_ );
+  out += ',';
+  add_uint( out, ptr->agg_.conf_ );
+  out += ',';
+  add_int( out, ptr->twap_.val_ );
+  out += ',';
+  add_int( out, ptr->twac_.val_ );
+  out += ',';
+  add_uint( out, ptr->num_qt_ );
+  out += ',';
+  add_uint( out, ptr->valid_slot_ );
+  out += ',';
+  add_uint( out, ptr->agg_.pub_slot_ );
+  out += ',';
+  add_uint( out, ptr->prev_slot_ );
+  out += ',';
+  add_int( out, ptr->prev_price_ );
+  out += ',';
+  add_uint( out, ptr->prev_conf_ );
   for( unsigned i=0; i != ptr->num_; ++i ) {
     pc_price_comp_t *cptr = &ptr->comp_[i];
-    std::cout << ',';
-    str sstr = symbol_status_to_str( (symbol_status)cptr->agg_.status_ );
-    std::cout.write( sstr.str_, sstr.len_ );
-    std::cout << ',' << cptr->agg_.price_
-              << ',' << cptr->agg_.conf_
-              << ',' << cptr->agg_.pub_slot_;
+    out += ',';
+    add_str( out,
+        symbol_status_to_str( (symbol_status)cptr->agg_.status_ ) );
+    out += ',';
+    add_int( out, cptr->agg_.price_ );
+    out += ',';
+    add_uint( out, cptr->agg_.conf_ );
+    out += ',';
+    add_uint( out, cptr->agg_.pub_slot_ );
   }
   for( unsigned i=ptr->num_; i != PC_COMP_SIZE; ++i ) {
-    std::cout << ",,,,";
+    out += ",,,,";
   }
-  std::cout << std::endl;
+  out += '\n';
+}
+
+void csv_print::parse_price( replay& rep )
+{
+  pc_price_t *ptr = (pc_price_t*)rep.get_update();
+  if ( !has_price( ptr ) ) {
+    return;
+  }
+  std::string out;
+  format_price( ptr, rep.get_time(), out );
+  std::cout << out;
 }
 
 void csv_print::parse( replay& rep )
@@ -172,12 +234,251 @@ void csv_print::parse( replay& rep )
   }
 }
 
+bool csv_print::parse_product_only( replay& rep )
+{
+  pc_acc_t *ptr = rep.get_update();
+  if ( ptr->type_ == PC_ACCTYPE_PRICE ) {
+    return false;
+  }
+  parse( rep );
+  return true;
+}
+
+// batch re-aggregation of captured price updates using the local
+// upd_aggregate implementation across a pool of threads
+class agg_engine
+{
+public:
+
+  agg_engine( csv_print& );
+  ~agg_engine();
+
+  // start worker threads
+  void init( unsigned num_thrd );
+
+  // add captured price update to current batch
+  void add( replay& );
+
+  // aggregate and print current batch
+  void flush();
+
+  // worker thread loop
+  void run();
+
+private:
+
+  struct trait_account {
+    static const size_t hsize_ = 8363UL;
+    typedef uint32_t     idx_t;
+    typedef pub_key      key_t;
+    typedef const key_t& keyref_t;
+    typedef uint32_t     val_t;
+    struct hash_t {
+      idx_t operator() ( keyref_t a ) {
+        uint64_t *p = (uint64_t*)a.data();
+        return p[0] ^ p[1];
+      }
+    };
+  };
+
+  typedef hash_map<trait_account>  state_map_t;
+  typedef std::vector<pc_price_t>  price_vec_t;
+  typedef std::vector<uint32_t>    idx_vec_t;
+  typedef std::vector<int64_t>     ts_vec_t;
+  typedef std::vector<uint8_t>     flag_vec_t;
+  typedef std::vector<std::string> str_vec_t;
+  typedef std::vector<std::thread> thrd_vec_t;
+
+  static const size_t max_batch = 4096;
+
+  void work( size_t num );
+  void aggregate( size_t i );
+
+  csv_print              *csv_;
+  state_map_t             amap_;   // account to state index
+  price_vec_t             state_;  // simulated price accounts
+  flag_vec_t              used_;   // state in current batch
+
+  // current batch (struct of arrays)
+  idx_vec_t               sidx_;   // state index
+  price_vec_t             upd_;    // captured price account
+  ts_vec_t                ts_;     // capture time
+  str_vec_t               out_;    // formatted csv row
+
+  // worker thread coordination
+  thrd_vec_t              thrd_;
+  std::mutex              mtx_;
+  std::condition_variable cv_;
+  std::condition_variable done_cv_;
+  std::atomic<size_t>     next_;
+  size_t                  num_;      // batch size of current generation
+  size_t                  num_done_; // workers done with current generation
+  uint64_t                gen_;
+  bool                    is_run_;
+};
+
+agg_engine::agg_engine( csv_print& csv )
+: csv_( &csv ),
+  next_( 0 ),
+  num_( 0 ),
+  num_done_( 0 ),
+  gen_( 0 ),
+  is_run_( true )
+{
+  sidx_.reserve( max_batch );
+  upd_.reserve( max_batch );
+  ts_.reserve( max_batch );
+  out_.resize( max_batch );
+}
+
+agg_engine::~agg_engine()
+{
+  mtx_.lock();
+  is_run_ = false;
+  mtx_.unlock();
+  cv_.notify_all();
+  for( std::thread& thrd: thrd_ ) {
+    thrd.join();
+  }
+}
+
+static void run_agg( agg_engine *eptr )
+{
+  eptr->run();
+}
+
+void agg_engine::init( unsigned num_thrd )
+{
+  for( unsigned i=1; i < num_thrd; ++i ) {
+    thrd_.push_back( std::thread( run_agg, this ) );
+  }
+}
+
+void agg_engine::run()
+{
+  // every worker checks in and out of each generation exactly once
+  // because flush() waits for all of them before starting the next
+  uint64_t gen = 0;
+  for(;;) {
+    size_t num;
+    {
+      std::unique_lock<std::mutex> lck( mtx_ );
+      cv_.wait( lck, [&]{ return !is_run_ || gen != gen_; } );
+      if ( !is_run_ ) {
+        return;
+      }
+      gen = gen_;
+      num = num_;
+    }
+    work( num );
+    std::lock_guard<std::mutex> lck( mtx_ );
+    if ( ++num_done_ == thrd_.size() ) {
+      done_cv_.notify_one();
+    }
+  }
+}
+
+void agg_engine::work( size_t num )
+{
+  for( size_t i; (i = next_.fetch_add( 1 )) < num; ) {
+    aggregate( i );
+  }
+}
+
+void agg_engine::aggregate( size_t i )
+{
+  pc_price_t *sptr = &state_[sidx_[i]];
+  pc_price_t *uptr = &upd_[i];
+
+  // re-run aggregation when capture shows a new aggregate slot,
+  // using the component quotes the on-chain aggregate saw
+  uint64_t slot = uptr->agg_.pub_slot_;
+  if ( slot > sptr->agg_.pub_slot_ ) {
+    sptr->num_ = uptr->num_;
+    sptr->expo_ = uptr->expo_;
+    for( uint32_t j=0; j != uptr->num_; ++j ) {
+      sptr->comp_[j].pub_ = uptr->comp_[j].pub_;
+      sptr->comp_[j].latest_ = uptr->comp_[j].agg_;
+    }
+    upd_aggregate( sptr, slot );
+  }
+  for( uint32_t j=0; j != uptr->num_; ++j ) {
+    sptr->comp_[j].latest_ = uptr->comp_[j].latest_;
+  }
+  out_[i].clear();
+  csv_->format_price( sptr, ts_[i], out_[i] );
+}
+
+void agg_engine::add( replay& rep )
+{
+  pc_price_t *ptr = (pc_price_t*)rep.get_update();
+  if ( !csv_->has_price( ptr ) ) {
+    return;
+  }
+
+  // find simulated state or seed it from first capture of account
+  pub_key *aptr = (pub_key*)rep.get_account();
+  state_map_t::iter_t it = amap_.find( *aptr );
+  if ( !it ) {
+    flush();
+    it = amap_.add( *aptr );
+    amap_.ref( it ) = state_.size();
+    state_.push_back( *ptr );
+    used_.push_back( 0 );
+  }
+  uint32_t idx = amap_.obj( it );
+
+  // each account appears at most once per batch
+  if ( used_[idx] || sidx_.size() == max_batch ) {
+    flush();
+  }
+  used_[idx] = 1;
+  sidx_.push_back( idx );
+  upd_.push_back( *ptr );
+  ts_.push_back( rep.get_time() );
+}
+
+void agg_engine::flush()
+{
+  size_t num = sidx_.size();
+  if ( !num ) {
+    return;
+  }
+  // run batch across worker threads and this thread. batch and state
+  // vectors are not touched again until every worker has checked out
+  {
+    std::lock_guard<std::mutex> lck( mtx_ );
+    next_ = 0;
+    num_ = num;
+    num_done_ = 0;
+    ++gen_;
+  }
+  cv_.notify_all();
+  work( num );
+  {
+    std::unique_lock<std::mutex> lck( mtx_ );
+    done_cv_.wait( lck, [&]{ return num_done_ == thrd_.size(); } );
+  }
+
+  // print rows in capture order
+  for( size_t i=0; i != num; ++i ) {
+    std::cout << out_[i];
+    used_[sidx_[i]] = 0;
+  }
+  sidx_.clear();
+  upd_.clear();
+  ts_.clear();
+}
+
 int usage()
 {
   std::cerr << "usage: pyth_csv <cap_file> [options]"
             << std::endl << std::endl;
   std::cerr << "options include:" << std::endl;
   std::cerr << "  -s <symbol>" << std::endl;
+  std::cerr << "  -a (re-compute aggregate prices from captured quotes)"
+            << std::endl;
+  std::cerr << "  -t <number of aggregation threads>" << std::endl;
   return 1;
 }
 
@@ -190,11 +491,15 @@ int main(int argc, char **argv)
   }
   int opt = 0;
   std::string cap_file = argv[1], symstr;
+  bool do_agg = false;
+  unsigned num_thrd = std::thread::hardware_concurrency();
   argc -= 1;
   argv += 1;
-  while( (opt = ::getopt(argc,argv, "s:h" )) != -1 ) {
+  while( (opt = ::getopt(argc,argv, "s:t:ah" )) != -1 ) {
     switch(opt) {
       case 's': symstr = optarg; break;
+      case 'a': do_agg = true; break;
+      case 't': num_thrd = ::atoi( optarg ); break;
       default: return usage();
     }
   }
@@ -211,6 +516,21 @@ int main(int argc, char **argv)
   csv.print_header();
   csv.set_symbol( symstr );
 
+  // re-compute aggregates in batches
+  if ( do_agg ) {
+    agg_engine eng( csv );
+    eng.init( std::max( num_thrd, 1U ) );
+    while( rep.get_next() ) {
+      if ( csv.parse_product_only( rep ) ) {
+        eng.flush();
+      } else {
+        eng.add( rep );
+      }
+    }
+    eng.flush();
+    return 0;
+  }
+
   // loop through and parse all updates in capture
   for(;;) {
     if ( rep.get_next() ) {
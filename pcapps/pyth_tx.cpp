@@ -32,6 +32,12 @@ int usage()
             << std::endl;
   std::cerr << "     tcp/ip port for pyth-client clients to connect to\n"
             << std::endl;
+  std::cerr << "  -b <slots_behind (default 1)>" << std::endl;
+  std::cerr << "     Also send to leaders of this many previous slots\n"
+            << std::endl;
+  std::cerr << "  -a <slots_ahead (default 4)>" << std::endl;
+  std::cerr << "     Also send to leaders of this many upcoming slots\n"
+            << std::endl;
   std::cerr << "  -l <log_file>" << std::endl;
   std::cerr << "     Optional log file - uses stderr if not provided\n"
             << std::endl;
@@ -66,18 +72,23 @@ int main(int argc, char **argv)
   // command-line parsing
   std::string log_file;
   std::string rpc_host = get_rpc_host();
-  int opt = 0, pyth_port = get_port();
+  int opt = 0, pyth_port = get_port(), lbehind = 1, lahead = 4;
   bool do_wait = true, do_debug = false;
-  while( (opt = ::getopt(argc,argv, "r:p:l:dnh" )) != -1 ) {
+  while( (opt = ::getopt(argc,argv, "r:p:b:a:l:dnh" )) != -1 ) {
     switch(opt) {
       case 'r': rpc_host = optarg; break;
       case 'p': pyth_port = ::atoi(optarg); break;
+      case 'b': lbehind = ::atoi(optarg); break;
+      case 'a': lahead = ::atoi(optarg); break;
       case 'd': do_debug = true; break;
       case 'l': log_file = optarg; break;
       case 'n': do_wait = false; break;
       default: return usage();
     }
   }
+  if ( lbehind < 0 || lahead < 0 ) {
+    return usage();
+  }
 
   // set up logging and disable SIGPIPE
   signal( SIGPIPE, SIG_IGN );
@@ -92,6 +103,7 @@ int main(int argc, char **argv)
   tx_svr mgr;
   mgr.set_rpc_host( rpc_host );
   mgr.set_listen_port( pyth_port );
+  mgr.set_leader_window( lbehind, lahead );
   if ( !mgr.init() ) {
     std::cerr << "pyth_tx: " << mgr.get_err_msg() << std::endl;
     return 1;
@@ -32,6 +32,9 @@ int usage()
             << std::endl;
   std::cerr << "     Host name or IP address of solana rpc node in the form "
                "host_name[:rpc_port[:ws_port]]\n" << std::endl;
+  std::cerr << "  -f <rpc_host>" << std::endl;
+  std::cerr << "     Additional solana rpc node racing rpc_host to deliver "
+               "account updates. May be repeated\n" << std::endl;
   std::cerr << "  -t <tx proxy host (default " << get_rpc_host() << ")>"
             << std::endl;
   std::cerr << "     Host name or IP address of running pyth_tx server\n"
@@ -48,6 +51,18 @@ int usage()
   std::cerr << "     Directory containing dashboard/ content\n" << std::endl;
   std::cerr << "  -c <capture file>" << std::endl;
   std::cerr << "     Optional capture will get compressed\n" << std::endl;
+  std::cerr << "  -i <snapshot file>" << std::endl;
+  std::cerr << "     Optional account snapshot saved periodically and loaded "
+               "on restart for a warm start\n" << std::endl;
+  std::cerr << "  -o <shared memory file>" << std::endl;
+  std::cerr << "     Optional shared-memory price feed for co-located readers "
+               "e.g. /dev/shm/pythd_price\n" << std::endl;
+  std::cerr << "  -e <shared memory file>" << std::endl;
+  std::cerr << "     Optional shared-memory ring for price updates from local "
+               "publishers e.g. /dev/shm/pythd_upd\n" << std::endl;
+  std::cerr << "  -g <multicast group ip_address:port>" << std::endl;
+  std::cerr << "     Optional udp multicast of aggregate prices "
+               "e.g. 239.1.1.1:8911\n" << std::endl;
   std::cerr << "  -l <log_file>" << std::endl;
   std::cerr << "     Optional log file - uses stderr if not provided\n"
             << std::endl;
@@ -57,6 +72,12 @@ int usage()
   std::cerr << "  -x" << std::endl;
   std::cerr << "     Disable connection to pyth_tx transaction proxy server"
                "\n" << std::endl;
+  std::cerr << "  -u" << std::endl;
+  std::cerr << "     Coalesce price updates so only the latest update per "
+               "symbol is sent each slot\n" << std::endl;
+  std::cerr << "  -s" << std::endl;
+  std::cerr << "     Resync stale accounts after rpc reconnect instead of "
+               "re-bootstrapping all accounts\n" << std::endl;
   std::cerr << "  -m <commitment_level>" << std::endl;
   std::cerr << "     Subscription commitment level: processed, confirmed or "
                "finalized\n" << std::endl;
@@ -87,25 +108,36 @@ int main(int argc, char **argv)
 {
   // command-line parsing
   commitment cmt = commitment::e_confirmed;
-  std::string cnt_dir, cap_file, log_file;
+  std::string cnt_dir, cap_file, snap_file, shm_file, log_file;
+  std::string ing_file, mcast_addr;
   std::string rpc_host = get_rpc_host();
   std::string key_dir  = get_key_store();
   std::string tx_host  = get_rpc_host();
+  std::vector<std::string> feed_hosts;
   int pyth_port = get_port();
   int opt = 0;
-  bool do_wait = true, do_tx = true, do_debug = false;
-  while( (opt = ::getopt(argc,argv, "r:t:p:k:w:c:l:m:dnxh" )) != -1 ) {
+  bool do_wait = true, do_tx = true, do_debug = false, do_coal = false;
+  bool do_sync = false;
+  while( (opt = ::getopt(argc,argv,
+          "r:f:t:p:k:w:c:i:o:e:g:l:m:dnxush" )) != -1 ) {
     switch(opt) {
       case 'r': rpc_host = optarg; break;
+      case 'f': feed_hosts.push_back( optarg ); break;
       case 't': tx_host = optarg; break;
       case 'p': pyth_port = ::atoi(optarg); break;
       case 'k': key_dir = optarg; break;
       case 'c': cap_file = optarg; break;
+      case 'i': snap_file = optarg; break;
+      case 'o': shm_file = optarg; break;
+      case 'e': ing_file = optarg; break;
+      case 'g': mcast_addr = optarg; break;
       case 'w': cnt_dir = optarg; break;
       case 'l': log_file = optarg; break;
       case 'm': cmt = str_to_commitment(optarg); break;
       case 'n': do_wait = false; break;
       case 'x': do_tx = false; break;
+      case 'u': do_coal = true; break;
+      case 's': do_sync = true; break;
       case 'd': do_debug = true; break;
       default: return usage();
     }
@@ -128,11 +160,20 @@ int main(int argc, char **argv)
   manager mgr;
   mgr.set_dir( key_dir );
   mgr.set_rpc_host( rpc_host );
+  for( const std::string& host: feed_hosts ) {
+    mgr.add_rpc_feed( host );
+  }
   mgr.set_tx_host( tx_host );
   mgr.set_listen_port( pyth_port );
   mgr.set_content_dir( cnt_dir );
   mgr.set_capture_file( cap_file );
+  mgr.set_snapshot_file( snap_file );
+  mgr.set_shm_file( shm_file );
+  mgr.set_shm_ingress_file( ing_file );
+  mgr.set_mcast_addr( mcast_addr );
   mgr.set_do_tx( do_tx );
+  mgr.set_do_coalesce( do_coal );
+  mgr.set_do_resync( do_sync );
   mgr.set_do_capture( !cap_file.empty() );
   mgr.set_commitment( cmt );
   if ( !mgr.init() ) {
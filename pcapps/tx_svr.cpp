@@ -33,7 +33,17 @@ bool tx_user::parse( const char *buf, size_t sz, size_t&len  )
     teardown();
     return false;
   }
-  mgr_->submit( (const char*)&hdr[1], hdr->size_ - sizeof( tx_hdr ) );
+  // drop transactions that cannot fit in one packet. packed
+  // multi-instruction transactions are otherwise forwarded as-is
+  size_t tlen = hdr->size_ - sizeof( tx_hdr );
+  if ( PC_UNLIKELY( tlen > PC_TX_MAX_SIZE ) ) {
+    PC_LOG_ERR( "drop oversized tx" )
+      .add( "fd", get_fd() )
+      .add( "size", tlen )
+      .end();
+  } else {
+    mgr_->submit( (const char*)&hdr[1], tlen );
+  }
   len = hdr->size_;
   return true;
 }
@@ -92,6 +102,21 @@ int tx_svr::get_listen_port() const
   return tsvr_.get_port();
 }
 
+void tx_svr::set_leader_window( uint32_t behind, uint32_t ahead )
+{
+  route_.set_window( behind, ahead );
+}
+
+uint32_t tx_svr::get_leader_behind() const
+{
+  return route_.get_behind();
+}
+
+uint32_t tx_svr::get_leader_ahead() const
+{
+  return route_.get_ahead();
+}
+
 bool tx_svr::init()
 {
   // initialize net_loop
@@ -203,21 +228,13 @@ void tx_svr::submit( const char *buf, size_t len )
 {
   PC_LOG_DBG( "submit tx" )
     .add( "slot", slot_ )
-    .add( "num_leaders", avec_.size() )
+    .add( "num_leaders", route_.get_num_dest() )
     .end();
-  for( ip_addr& addr: avec_ ) {
-    tconn_.send( &addr, buf, len );
+  for( uint32_t i = 0; i != route_.get_num_dest(); ++i ) {
+    tconn_.send( route_.get_dest( i ), buf, len );
   }
 }
 
-void tx_svr::add_addr( const ip_addr& addr )
-{
-  for( ip_addr& iaddr: avec_ ) {
-    if ( iaddr == addr ) return;
-  }
-  avec_.push_back( addr );
-}
-
 void tx_svr::on_response( rpc::slot_subscribe *res )
 {
   // check error
@@ -235,8 +252,12 @@ void tx_svr::on_response( rpc::slot_subscribe *res )
   slot_ = slot;
 
   // submit heartbeat every so often to keep connection alive
+  // and refresh cluster nodes if any leader addresses are missing
   if ( slot_cnt_++ % PC_HBEAT_INTERVAL == 0 ) {
     clnt_.send( hreq_ );
+    if ( route_.get_num_missing() && creq_->get_is_recv() ) {
+      clnt_.send( creq_ );
+    }
   }
 
   // request next slot leader schedule
@@ -246,39 +267,11 @@ void tx_svr::on_response( rpc::slot_subscribe *res )
     clnt_.send( lreq_ );
   }
 
-  // construct unique list of addresses of the leaders for
-  // the previous and next num_slots
-  avec_.clear();
-  pub_key *pkey = nullptr;
-  ip_addr iaddr;
-  uint64_t max_slot = std::min( slot_+5, lreq_->get_last_slot() );
-  for( uint64_t slot = slot_-1; slot < max_slot; ++slot ) {
-    pub_key *ikey = lreq_->get_leader( slot );
-    if ( ikey && ( !pkey || *ikey != *pkey) ) {
-      if ( creq_->get_ip_addr( *ikey, iaddr ) ) {
-        add_addr( iaddr );
-      } else {
-        PC_LOG_WRN( "missing leader addr" )
-          .add( "leader", *ikey )
-          .add( "curr_slot", slot )
-          .add( "start_slot", slot_-1 )
-          .add( "end_slot", slot_+4 )
-          .add( "last_slot", lreq_->get_last_slot() )
-          .end();
-        if ( creq_->get_is_recv() ) {
-          clnt_.send( creq_ );
-        }
-        if ( lreq_->get_is_recv() ) {
-          lreq_->set_slot( slot_ - PC_LEADER_MIN );
-          clnt_.send( lreq_ );
-        }
-      }
-    }
-    pkey = ikey;
-  }
+  // switch to precomputed destinations of current slot
+  route_.set_slot( slot_ );
   PC_LOG_DBG( "receive slot" )
     .add( "slot", slot_ )
-    .add( "num_leaders", avec_.size() )
+    .add( "num_leaders", route_.get_num_dest() )
     .end();
 }
 
@@ -291,6 +284,7 @@ void tx_svr::on_response( rpc::get_cluster_nodes *m )
     return;
   }
   PC_LOG_DBG( "received get_cluster_nodes" ).end();
+  route_.build( lreq_, creq_ );
 }
 
 void tx_svr::on_response( rpc::get_slot_leaders *m )
@@ -304,6 +298,7 @@ void tx_svr::on_response( rpc::get_slot_leaders *m )
   PC_LOG_DBG( "received get_slot_leaders" )
     .add( "curr_slot", slot_ )
     .add( "last_slot", m->get_last_slot() ).end();
+  route_.build( lreq_, creq_ );
 }
 
 void tx_svr::on_response( rpc::get_health *m )
@@ -338,7 +333,7 @@ void tx_svr::reconnect_rpc()
     has_conn_  = true;
     wait_conn_ = false;
     slot_ = 0L;
-    avec_.clear();
+    route_.reset();
     clnt_.reset();
     ctimeout_ = PC_NSECS_IN_SEC;
     lreq_->set_recv_time( lreq_->get_sent_time() );
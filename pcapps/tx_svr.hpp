@@ -2,7 +2,9 @@
 
 #include <pc/net_socket.hpp>
 #include <pc/rpc_client.hpp>
+#include <pc/leader_route.hpp>
 #include <pc/dbl_list.hpp>
+#include <pc/log.hpp>
 
 namespace pc
 {
@@ -46,6 +48,12 @@ namespace pc
     void set_listen_port( int port );
     int get_listen_port() const;
 
+    // number of slots before and after the current slot whose leaders
+    // receive each transaction (default 1 and 4)
+    void set_leader_window( uint32_t behind, uint32_t ahead );
+    uint32_t get_leader_behind() const;
+    uint32_t get_leader_ahead() const;
+
     // initialize
     bool init();
 
@@ -72,13 +80,11 @@ namespace pc
 
   private:
 
-    typedef dbl_list<tx_user>    user_list_t;
-    typedef std::vector<ip_addr> addr_vec_t;
+    typedef dbl_list<tx_user>     user_list_t;
 
     void reconnect_rpc();
     void log_disconnect();
     void teardown_users();
-    void add_addr( const ip_addr& );
 
     static const size_t buf_len = 2048;
 
@@ -90,7 +96,7 @@ namespace pc
     ip_addr      src_[1];      // src ip address
     uint64_t     slot_;        // current slot
     uint64_t     slot_cnt_;    // number of slots received
-    addr_vec_t   avec_;        // address vector of leaders
+    leader_route route_;       // tx destinations by slot
     tcp_connect  hconn_;       // rpc http connection
     ws_connect   wconn_;       // rpc websocket sonnection
     udp_socket   tconn_;       // udp sending socket
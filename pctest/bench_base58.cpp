@@ -0,0 +1,69 @@
+#include <pc/misc.hpp>
+#include <iostream>
+
+// base58 fixed-length codecs against generic base-x conversion
+
+using namespace pc;
+
+static const unsigned num_key = 1024;
+static const unsigned num_iter = 200000;
+
+static uint64_t next_rand( uint64_t& seed )
+{
+  seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+  return seed >> 33;
+}
+
+template<unsigned N>
+static int enc_generic( const uint8_t *src, uint8_t *res, int rlen )
+{
+  return enc_base58( src, N, res, rlen );
+}
+
+template<unsigned N>
+static uint64_t bench_codec( const char *name, uint64_t& seed,
+    int (*enc)( const uint8_t *, uint8_t *, int ),
+    int (*dec)( const uint8_t *, int, uint8_t * ) )
+{
+  static uint8_t key[num_key][N];
+  static uint8_t txt[num_key][2*N];
+  static int     tlen[num_key];
+  uint8_t buf[2*N+2];
+  uint64_t chk = 0;
+  for( unsigned i=0; i != num_key; ++i ) {
+    for( unsigned j=0; j != N; ++j ) {
+      key[i][j] = (uint8_t)next_rand( seed );
+    }
+  }
+  int64_t ts = get_now();
+  for( unsigned i=0; i != num_iter; ++i ) {
+    unsigned k = i%num_key;
+    tlen[k] = enc( key[k], txt[k], 2*N );
+    chk += txt[k][0];
+  }
+  int64_t te = get_now();
+  for( unsigned i=0; i != num_iter; ++i ) {
+    unsigned k = i%num_key;
+    chk += dec( txt[k], tlen[k], buf );
+    chk += buf[N/2];
+  }
+  int64_t td = get_now();
+  std::cout << name << " len=" << N
+            << " ns_per_enc=" << (double)(te-ts)/(double)num_iter
+            << " ns_per_dec=" << (double)(td-te)/(double)num_iter
+            << std::endl;
+  return chk;
+}
+
+int main( int, char** )
+{
+  uint64_t seed = 42UL, chk = 0UL;
+  chk += bench_codec<32>( "generic", seed, enc_generic<32>, dec_base58 );
+  chk += bench_codec<32>( "fixed", seed,
+      enc_base58_fixed<32>, dec_base58_fixed<32> );
+  chk += bench_codec<64>( "generic", seed, enc_generic<64>, dec_base58 );
+  chk += bench_codec<64>( "fixed", seed,
+      enc_base58_fixed<64>, dec_base58_fixed<64> );
+  // keep result live
+  return chk == 0UL;
+}
@@ -0,0 +1,154 @@
+char heap_start[8192];
+#define PC_HEAP_START (heap_start)
+
+#include <stdint.h>
+#include <stdio.h>
+#include <oracle/oracle.h>
+#include <oracle/upd_aggregate.h>
+#include <pc/misc.hpp>
+#include <iostream>
+
+// benchmark of upd_aggregate and quote sorting for 1 to PC_COMP_SIZE
+// quoters
+
+using namespace pc;
+
+static const uint64_t num_iter = 100000UL;
+
+static uint64_t next_rand( uint64_t& seed )
+{
+  seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+  return seed >> 33;
+}
+
+static uint64_t bench_agg( uint64_t& seed )
+{
+  uint64_t chk = 0UL;
+  for( uint32_t numq = 1; numq <= PC_COMP_SIZE; ++numq ) {
+    // random quotes around a common price
+    pc_price_t px[1];
+    __builtin_memset( px, 0, sizeof( pc_price_t ) );
+    px->expo_ = -5;
+    px->num_  = numq;
+    for( uint32_t i=0; i != numq; ++i ) {
+      pc_price_comp_t *ptr = &px->comp_[i];
+      ptr->latest_.status_ = PC_STATUS_TRADING;
+      ptr->latest_.price_  = 10000000L + (int64_t)( next_rand( seed )%200000 );
+      ptr->latest_.conf_   = 1000UL + next_rand( seed )%20000;
+    }
+
+    // aggregate once per slot with quotes aging up to max latency
+    uint64_t slot = 1000UL;
+    int64_t ts = get_now();
+    for( uint64_t it=0; it != num_iter; ++it, ++slot ) {
+      uint64_t pub_slot = slot - it%PC_MAX_SEND_LATENCY;
+      for( uint32_t i=0; i != numq; ++i ) {
+        px->comp_[i].latest_.pub_slot_ = pub_slot;
+      }
+      upd_aggregate( px, slot );
+      chk += px->agg_.price_;
+    }
+    int64_t dt = get_now() - ts;
+    std::cout << "upd_aggregate num_quoters=" << numq
+              << " ns_per_agg=" << (double)dt/(double)num_iter
+              << std::endl;
+  }
+  return chk;
+}
+
+// batcher odd-even merge sort network for 32 inputs. comparators are
+// in depth-first order so the network for the first 2^k inputs is a
+// prefix of length srt_net_len[k]
+static const uint8_t srt_net[191][2] = {
+  {0,1},{2,3},{0,2},{1,3},{1,2},{4,5},{6,7},{4,6},{5,7},{5,6},{0,4},{2,6},
+  {2,4},{1,5},{3,7},{3,5},{1,2},{3,4},{5,6},{8,9},{10,11},{8,10},{9,11},
+  {9,10},{12,13},{14,15},{12,14},{13,15},{13,14},{8,12},{10,14},{10,12},
+  {9,13},{11,15},{11,13},{9,10},{11,12},{13,14},{0,8},{4,12},{4,8},{2,10},
+  {6,14},{6,10},{2,4},{6,8},{10,12},{1,9},{5,13},{5,9},{3,11},{7,15},
+  {7,11},{3,5},{7,9},{11,13},{1,2},{3,4},{5,6},{7,8},{9,10},{11,12},
+  {13,14},{16,17},{18,19},{16,18},{17,19},{17,18},{20,21},{22,23},{20,22},
+  {21,23},{21,22},{16,20},{18,22},{18,20},{17,21},{19,23},{19,21},{17,18},
+  {19,20},{21,22},{24,25},{26,27},{24,26},{25,27},{25,26},{28,29},{30,31},
+  {28,30},{29,31},{29,30},{24,28},{26,30},{26,28},{25,29},{27,31},{27,29},
+  {25,26},{27,28},{29,30},{16,24},{20,28},{20,24},{18,26},{22,30},{22,26},
+  {18,20},{22,24},{26,28},{17,25},{21,29},{21,25},{19,27},{23,31},{23,27},
+  {19,21},{23,25},{27,29},{17,18},{19,20},{21,22},{23,24},{25,26},{27,28},
+  {29,30},{0,16},{8,24},{8,16},{4,20},{12,28},{12,20},{4,8},{12,16},
+  {20,24},{2,18},{10,26},{10,18},{6,22},{14,30},{14,22},{6,10},{14,18},
+  {22,26},{2,4},{6,8},{10,12},{14,16},{18,20},{22,24},{26,28},{1,17},
+  {9,25},{9,17},{5,21},{13,29},{13,21},{5,9},{13,17},{21,25},{3,19},
+  {11,27},{11,19},{7,23},{15,31},{15,23},{7,11},{15,19},{23,27},{3,5},
+  {7,9},{11,13},{15,17},{19,21},{23,25},{27,29},{1,2},{3,4},{5,6},{7,8},
+  {9,10},{11,12},{13,14},{15,16},{17,18},{19,20},{21,22},{23,24},{25,26},
+  {27,28},{29,30}
+};
+static const uint8_t srt_net_len[6] = { 0, 1, 5, 19, 63, 191 };
+
+// branch-free sorting network alternative to srt_quotes. inputs are
+// padded to the next power of two with sentinels and ties are ordered
+// by index, so result is the same as a stable sort in ascending order
+static void srt_network( int64_t *prc, uint32_t *idx, uint32_t num )
+{
+  uint32_t k = 0;
+  for( ; (1U<<k) < num; ++k );
+  for( uint32_t i = num; i != (1U<<k); ++i ) {
+    prc[i] = INT64_MAX;
+    idx[i] = i;
+  }
+  for( uint32_t i = 0; i != srt_net_len[k]; ++i ) {
+    uint32_t a = srt_net[i][0], b = srt_net[i][1];
+    int64_t  pa = prc[a], pb = prc[b];
+    uint32_t ia = idx[a], ib = idx[b];
+    int64_t  m = -(int64_t)( ( pa > pb ) | ( ( pa == pb ) & ( ia > ib ) ) );
+    int64_t  dp = ( pa ^ pb ) & m;
+    uint32_t di = ( ia ^ ib ) & (uint32_t)m;
+    prc[a] = pa ^ dp;
+    prc[b] = pb ^ dp;
+    idx[a] = ia ^ di;
+    idx[b] = ib ^ di;
+  }
+}
+
+typedef void (*srt_fn_t)( int64_t *, uint32_t *, uint32_t );
+
+static uint64_t bench_sort( uint64_t& seed, const char *name, srt_fn_t fn )
+{
+  // pre-generate random quote sets so timing only covers sorting
+  static const uint32_t num_set = 1024;
+  static int64_t prc[num_set][PC_COMP_SIZE];
+  int64_t  wprc[PC_COMP_SIZE];
+  uint32_t widx[PC_COMP_SIZE];
+  uint64_t chk = 0UL;
+  for( uint32_t s=0; s != num_set; ++s ) {
+    for( uint32_t i=0; i != PC_COMP_SIZE; ++i ) {
+      prc[s][i] = (int64_t)( next_rand( seed )%200000 );
+    }
+  }
+  for( uint32_t numq = 1; numq <= PC_COMP_SIZE; ++numq ) {
+    int64_t ts = get_now();
+    for( uint64_t it=0; it != num_iter; ++it ) {
+      int64_t *sptr = prc[it%num_set];
+      for( uint32_t i=0; i != numq; ++i ) {
+        wprc[i] = sptr[i];
+        widx[i] = i;
+      }
+      fn( wprc, widx, numq );
+      chk += widx[0];
+    }
+    int64_t dt = get_now() - ts;
+    std::cout << name << " num_quoters=" << numq
+              << " ns_per_sort=" << (double)dt/(double)num_iter
+              << std::endl;
+  }
+  return chk;
+}
+
+int main( int, char** )
+{
+  uint64_t seed = 42UL, chk = 0UL;
+  chk += bench_agg( seed );
+  chk += bench_sort( seed, "srt_quotes", srt_quotes );
+  chk += bench_sort( seed, "srt_network", srt_network );
+  // keep result live
+  return chk == 0UL;
+}
@@ -0,0 +1,84 @@
+#include <pc/shm_price.hpp>
+#include <pc/misc.hpp>
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+// shared-memory price feed writer to reader latency benchmark
+
+using namespace pc;
+
+static const uint32_t num_price = 256;
+static const uint64_t num_upd   = 1000000;
+
+static void run_writer( shm_price_wtr *wtr, std::atomic<bool> *is_run )
+{
+  shm::price rec;
+  __builtin_memset( &rec, 0, sizeof( rec ) );
+  for( uint64_t i=0; i != num_upd && *is_run; ++i ) {
+    rec.price_ = (int64_t)i;
+    rec.pub_slot_ = i;
+    rec.ts_ = get_now();
+    wtr->update( (uint32_t)( i % num_price ), rec );
+    // pace writer so reader is not permanently overrun
+    for( int64_t ts = rec.ts_; get_now() - ts < 1000L; );
+  }
+}
+
+int main( int argc, char **argv )
+{
+  std::string file = argc > 1 ? argv[1] : "/dev/shm/bench_shm";
+  shm_price_wtr wtr;
+  wtr.set_file( file );
+  wtr.set_max_price( num_price );
+  if ( !wtr.init() ) {
+    std::cerr << "bench_shm: " << wtr.get_err_msg() << std::endl;
+    return 1;
+  }
+  shm_price_rdr rdr;
+  rdr.set_file( file );
+  if ( !rdr.init() ) {
+    std::cerr << "bench_shm: " << rdr.get_err_msg() << std::endl;
+    return 1;
+  }
+
+  // reader polls ring and reads each updated price record
+  std::atomic<bool> is_run( true );
+  std::thread thrd( run_writer, &wtr, &is_run );
+  std::vector<int64_t> lat;
+  lat.reserve( num_upd );
+  uint64_t num_torn = 0;
+  shm::price rec;
+  uint32_t hdl;
+  while( lat.size() + rdr.get_num_overrun() < num_upd ) {
+    if ( !rdr.get_next( hdl ) ) {
+      if ( rdr.get_num_overrun() ) break;
+      continue;
+    }
+    if ( rdr.get_price( hdl, rec ) ) {
+      lat.push_back( get_now() - rec.ts_ );
+      num_torn += (uint64_t)rec.price_ % num_price != hdl;
+    }
+  }
+  is_run = false;
+  thrd.join();
+  ::unlink( file.c_str() );
+
+  if ( lat.empty() ) {
+    std::cerr << "bench_shm: no updates received" << std::endl;
+    return 1;
+  }
+  std::sort( lat.begin(), lat.end() );
+  std::cout << "num_upd=" << lat.size()
+            << " num_overrun=" << rdr.get_num_overrun()
+            << " num_mismatch=" << num_torn
+            << " lat_ns(p50,p90,p99,p999)=" << lat[lat.size()/2]
+            << "," << lat[lat.size()*9/10]
+            << "," << lat[lat.size()*99/100]
+            << "," << lat[lat.size()*999/1000]
+            << std::endl;
+  return 0;
+}
@@ -0,0 +1,66 @@
+#include <pc/net_socket.hpp>
+#include <pc/misc.hpp>
+#include <iostream>
+#include <vector>
+
+// websocket masking throughput benchmark
+
+using namespace pc;
+
+static void mask_bytes( char *buf, size_t len, const char *mask, size_t pos )
+{
+  for( size_t i=0; i != len; ++i ) {
+    buf[i] ^= mask[(pos+i)%4];
+  }
+}
+
+typedef void (*mask_fn_t)( char *, size_t, const char *, size_t );
+
+static void bench_mask( const char *name, mask_fn_t fn, size_t len )
+{
+  static const size_t tot_len = 1UL<<30;
+  const char mask[4] = { 0x12, 0x34, 0x56, 0x78 };
+  std::vector<char> buf( len + 1, 'x' );
+  size_t num = tot_len / len;
+  int64_t ts = get_now();
+  for( size_t i=0; i != num; ++i ) {
+    // odd offset to exercise unaligned payloads
+    fn( &buf[1], len, mask, i );
+  }
+  int64_t dt = get_now() - ts;
+  std::cout << name << " len=" << len
+            << " MB_per_sec=" << (double)(num*len)*1e3/(double)dt
+            << " chk=" << (int)buf[len/2]
+            << std::endl;
+}
+
+static void bench_commit( size_t len )
+{
+  // frame construction and masking across net_buf chain
+  static const size_t tot_len = 1UL<<28;
+  std::string txt( len, 'x' );
+  size_t num = tot_len / len;
+  int64_t ts = get_now();
+  for( size_t i=0; i != num; ++i ) {
+    net_wtr pay;
+    pay.add( txt );
+    ws_wtr msg;
+    msg.commit( ws_wtr::text_id, pay, true );
+  }
+  int64_t dt = get_now() - ts;
+  std::cout << "ws_wtr::commit len=" << len
+            << " MB_per_sec=" << (double)(num*len)*1e3/(double)dt
+            << std::endl;
+}
+
+int main( int, char** )
+{
+  for( size_t len: { 64UL, 1270UL, 65536UL } ) {
+    bench_mask( "mask_bytes", mask_bytes, len );
+    bench_mask( "ws_wtr::apply_mask", ws_wtr::apply_mask, len );
+  }
+  for( size_t len: { 1270UL, 65536UL } ) {
+    bench_commit( len );
+  }
+  return 0;
+}
@@ -0,0 +1,42 @@
+#include <pc/mcast.hpp>
+#include <pc/misc.hpp>
+#include <iostream>
+
+// reference receiver of pythd multicast price feed reporting
+// message counts, sequence gaps and publisher restarts once per second
+
+using namespace pc;
+
+int main( int argc, char **argv )
+{
+  if ( argc < 2 ) {
+    std::cerr << "usage: mcast_recv <group ip_address:port>" << std::endl;
+    return 1;
+  }
+  net_loop nl;
+  if ( !nl.init() ) {
+    std::cerr << "mcast_recv: " << nl.get_err_msg() << std::endl;
+    return 1;
+  }
+  mcast_sub sub;
+  sub.set_addr( argv[1] );
+  sub.set_net_loop( &nl );
+  if ( !sub.init() ) {
+    std::cerr << "mcast_recv: " << sub.get_err_msg() << std::endl;
+    return 1;
+  }
+  for( int64_t ts = get_now();; ) {
+    nl.poll( 1000 );
+    int64_t now = get_now();
+    if ( now - ts < PC_NSECS_IN_SEC ) {
+      continue;
+    }
+    ts = now;
+    std::cout << "num_recv=" << sub.get_num_recv()
+              << " num_upd=" << sub.get_num_upd()
+              << " num_snap=" << sub.get_num_snap()
+              << " num_gap=" << sub.get_num_gap()
+              << " num_restart=" << sub.get_num_restart()
+              << std::endl;
+  }
+}
@@ -1,8 +1,13 @@
 #include "test_error.hpp"
 #include <pc/net_socket.hpp>
-#include <pc/net_socket.hpp>
+#include <pc/user_bin.hpp>
+#include <pc/rpc_client.hpp>
+#include <pc/mcast.hpp>
+#include <pc/manager.hpp>
 #include <pc/misc.hpp>
 #include <iostream>
+#include <sys/socket.h>
+#include <unistd.h>
 
 using namespace pc;
 
@@ -124,12 +129,581 @@ void test_enc()
   PC_TEST_CHECK( -954 == str_to_dec( "-0.000954000", -6 ) );
 }
 
+class test_ws_parser : public ws_parser
+{
+public:
+  void parse_msg( const char *buf, size_t sz ) override {
+    msg_.assign( buf, sz );
+  }
+  std::string msg_;
+};
+
+void test_ws_mask()
+{
+  // wide masking matches byte-by-byte masking at any offset
+  const char mask[4] = { 0x12, 0x34, 0x56, 0x78 };
+  char buf[128], ref[128];
+  for( size_t len=0; len != 100; ++len ) {
+    for( size_t pos=0; pos != 8; ++pos ) {
+      for( size_t i=0; i != len; ++i ) {
+        buf[i] = ref[i] = (char)( i * 7 + len );
+        ref[i] ^= mask[(pos+i)%4];
+      }
+      ws_wtr::apply_mask( buf, len, mask, pos );
+      PC_TEST_CHECK( 0 == __builtin_memcmp( buf, ref, len ) );
+    }
+  }
+
+  // masked frame spanning several net_bufs round-trips through parser
+  std::string txt;
+  for( unsigned i=0; i != 5000; ++i ) {
+    txt += (char)( 'a' + i%26 );
+  }
+  net_wtr pay;
+  pay.add( txt );
+  ws_wtr msg;
+  msg.commit( ws_wtr::text_id, pay, true );
+  net_buf *hd, *tl;
+  msg.detach( hd, tl );
+  std::string frame;
+  while( hd ) {
+    net_buf *nxt = hd->next_;
+    frame.append( hd->buf_, hd->size_ );
+    hd->dealloc();
+    hd = nxt;
+  }
+  PC_TEST_CHECK( frame.find( txt.substr( 0, 16 ) ) == std::string::npos );
+  test_ws_parser wp;
+  size_t len = 0;
+  PC_TEST_CHECK( wp.parse( &frame[0], frame.size(), len ) );
+  PC_TEST_CHECK( len == frame.size() );
+  PC_TEST_CHECK( wp.msg_ == txt );
+}
+
+class test_rbuf_parser : public test_ws_parser
+{
+public:
+  test_rbuf_parser() : nparse_( 0 ), nmsg_( 0 ) {}
+  bool parse( const char *buf, size_t sz, size_t& len ) override {
+    ++nparse_;
+    return ws_parser::parse( buf, sz, len );
+  }
+  void parse_msg( const char *buf, size_t sz ) override {
+    test_ws_parser::parse_msg( buf, sz );
+    ++nmsg_;
+  }
+  unsigned nparse_;
+  unsigned nmsg_;
+};
+
+static void add_ws_frame( std::string& frame, int op, bool fin,
+                          const std::string& pay )
+{
+  frame += (char)( ( fin ? 0x80 : 0 ) | op );
+  if ( pay.size() < 126 ) {
+    frame += (char)pay.size();
+  } else if ( pay.size() < 65536 ) {
+    frame += (char)126;
+    frame += (char)( pay.size() >> 8 );
+    frame += (char)( pay.size() & 0xff );
+  } else {
+    frame += (char)127;
+    for( int i=7; i>=0; --i ) {
+      frame += (char)( ( pay.size() >> ( 8*i ) ) & 0xff );
+    }
+  }
+  frame += pay;
+}
+
+void test_read_buf()
+{
+  int fd[2];
+  PC_TEST_CHECK( 0 == ::socketpair( AF_UNIX, SOCK_STREAM, 0, fd ) );
+  test_rbuf_parser wp;
+  net_connect conn;
+  conn.set_fd( fd[0] );
+  conn.set_block( false );
+  conn.set_net_parser( &wp );
+  wp.set_net_connect( &conn );
+
+  // fragmented message trickled in a few bytes at a time
+  std::string frame, txt;
+  for( unsigned i=0; i != 3; ++i ) {
+    std::string part( 300, (char)( 'a' + i ) );
+    txt += part;
+    add_ws_frame( frame, i ? ws_wtr::cont_id : ws_wtr::text_id, i==2, part );
+  }
+  for( size_t i=0; i < frame.size(); i += 7 ) {
+    size_t len = std::min( (size_t)7, frame.size() - i );
+    PC_TEST_CHECK( (ssize_t)len == ::send( fd[1], &frame[i], len, 0 ) );
+    conn.poll_recv();
+  }
+  PC_TEST_CHECK( wp.nmsg_ == 1 );
+  PC_TEST_CHECK( wp.msg_ == txt );
+  PC_TEST_CHECK( conn.get_read_buf().size() == 0 );
+  PC_TEST_CHECK( conn.get_read_buf().get_recv_bytes() == frame.size() );
+
+  // large frame grows buffer once to fit and is only parsed when complete
+  std::string big( 200000, 'x' );
+  frame.clear();
+  add_ws_frame( frame, ws_wtr::binary_id, true, big );
+  wp.nparse_ = 0;
+  uint64_t nalloc = conn.get_read_buf().get_num_realloc();
+  for( size_t i=0; i < frame.size(); i += 4096 ) {
+    size_t len = std::min( (size_t)4096, frame.size() - i );
+    PC_TEST_CHECK( (ssize_t)len == ::send( fd[1], &frame[i], len, 0 ) );
+    conn.poll_recv();
+  }
+  PC_TEST_CHECK( wp.nmsg_ == 2 );
+  PC_TEST_CHECK( wp.msg_ == big );
+  PC_TEST_CHECK( wp.nparse_ == 2 );
+  PC_TEST_CHECK( conn.get_read_buf().get_num_realloc() - nalloc <= 2 );
+  PC_TEST_CHECK( conn.get_read_buf().get_move_bytes() < 8192 );
+  PC_TEST_CHECK( !conn.get_is_err() );
+  conn.close();
+  ::close( fd[1] );
+}
+
+void test_reconnect()
+{
+  int fd[2];
+  PC_TEST_CHECK( 0 == ::socketpair( AF_UNIX, SOCK_STREAM, 0, fd ) );
+  test_rbuf_parser wp;
+  net_connect conn;
+  conn.set_fd( fd[0] );
+  conn.set_block( false );
+  conn.set_net_parser( &wp );
+  wp.set_net_connect( &conn );
+
+  // connection drops with a fragment and part of a large frame pending
+  std::string frame;
+  add_ws_frame( frame, ws_wtr::text_id, false, "abc" );
+  std::string big;
+  add_ws_frame( big, ws_wtr::cont_id, true, std::string( 200000, 'x' ) );
+  frame.append( big, 0, 1000 );
+  PC_TEST_CHECK( (ssize_t)frame.size() ==
+                 ::send( fd[1], frame.data(), frame.size(), 0 ) );
+  conn.poll_recv();
+  PC_TEST_CHECK( wp.get_need() > 1000 );
+  conn.teardown();
+  ::close( fd[1] );
+  PC_TEST_CHECK( wp.get_need() == 0 );
+
+  // small message on new connection is parsed on its own
+  PC_TEST_CHECK( 0 == ::socketpair( AF_UNIX, SOCK_STREAM, 0, fd ) );
+  conn.set_fd( fd[0] );
+  conn.set_block( false );
+  frame.clear();
+  add_ws_frame( frame, ws_wtr::text_id, true, "hello" );
+  PC_TEST_CHECK( (ssize_t)frame.size() ==
+                 ::send( fd[1], frame.data(), frame.size(), 0 ) );
+  conn.poll_recv();
+  PC_TEST_CHECK( wp.nmsg_ == 1 );
+  PC_TEST_CHECK( wp.msg_ == "hello" );
+  PC_TEST_CHECK( !conn.get_is_err() );
+  conn.close();
+  ::close( fd[1] );
+}
+
+void test_send_size()
+{
+  int fd[2];
+  PC_TEST_CHECK( 0 == ::socketpair( AF_UNIX, SOCK_STREAM, 0, fd ) );
+  net_connect conn;
+  conn.set_fd( fd[0] );
+  conn.set_block( false );
+  PC_TEST_CHECK( conn.get_send_size() == 0 );
+
+  // queue more than the socket buffer holds
+  std::string txt( 4000, 'x' );
+  size_t num = 0;
+  for( unsigned i=0; i != 500; ++i ) {
+    net_wtr msg;
+    msg.add( txt );
+    conn.add_send( msg );
+    num += txt.size();
+  }
+  PC_TEST_CHECK( conn.get_send_size() == num );
+  conn.poll_send();
+  PC_TEST_CHECK( conn.get_send_size() < num );
+  PC_TEST_CHECK( conn.get_send_size() > 0 );
+
+  // queue drains as peer reads
+  char buf[65536];
+  size_t nrecv = 0;
+  while( conn.get_is_send() ) {
+    ssize_t len = ::recv( fd[1], buf, sizeof( buf ), 0 );
+    PC_TEST_CHECK( len > 0 );
+    nrecv += len;
+    conn.poll_send();
+    PC_TEST_CHECK( conn.get_send_size() <= num - nrecv );
+  }
+  PC_TEST_CHECK( conn.get_send_size() == 0 );
+  PC_TEST_CHECK( conn.get_max_send_size() == num );
+  conn.close();
+  ::close( fd[1] );
+}
+
+class test_bin_parser : public test_ws_parser
+{
+public:
+  test_bin_parser() : nbin_( 0 ) {}
+  bool accept_protocol( str prot ) override {
+    return prot == str( PC_BIN_PROTOCOL );
+  }
+  void parse_bin_msg( const char *, size_t ) override {
+    ++nbin_;
+  }
+  unsigned nbin_;
+};
+
+void test_ws_protocol()
+{
+  int fd[2];
+  PC_TEST_CHECK( 0 == ::socketpair( AF_UNIX, SOCK_STREAM, 0, fd ) );
+  test_bin_parser wp;
+  http_server hs;
+  net_connect conn;
+  conn.set_fd( fd[0] );
+  conn.set_block( false );
+  conn.set_net_parser( &hs );
+  hs.set_net_connect( &conn );
+  hs.set_ws_parser( &wp );
+
+  // first accepted subprotocol is echoed in upgrade response
+  std::string req =
+    "GET / HTTP/1.1\r\n"
+    "Upgrade: websocket\r\n"
+    "Connection: Upgrade\r\n"
+    "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+    "Sec-WebSocket-Protocol: json, " PC_BIN_PROTOCOL "\r\n"
+    "\r\n";
+  PC_TEST_CHECK( (ssize_t)req.size() ==
+      ::send( fd[1], req.data(), req.size(), 0 ) );
+  conn.poll_recv();
+  conn.poll_send();
+  char buf[1024];
+  ssize_t rlen = ::recv( fd[1], buf, sizeof( buf ), 0 );
+  PC_TEST_CHECK( rlen > 0 );
+  std::string rsp( buf, rlen > 0 ? rlen : 0 );
+  PC_TEST_CHECK( rsp.find( "101" ) != std::string::npos );
+  PC_TEST_CHECK( rsp.find( "Sec-WebSocket-Protocol: " PC_BIN_PROTOCOL ) !=
+                 std::string::npos );
+  PC_TEST_CHECK( conn.get_net_parser() == &wp );
+
+  // binary and text frames are dispatched separately
+  std::string frame;
+  add_ws_frame( frame, ws_wtr::binary_id, true, std::string( 8, '\0' ) );
+  add_ws_frame( frame, ws_wtr::text_id, true, "{}" );
+  PC_TEST_CHECK( (ssize_t)frame.size() ==
+      ::send( fd[1], frame.data(), frame.size(), 0 ) );
+  conn.poll_recv();
+  PC_TEST_CHECK( wp.nbin_ == 1 );
+  PC_TEST_CHECK( wp.msg_ == "{}" );
+  conn.close();
+  ::close( fd[1] );
+}
+
+void test_bin_wtr()
+{
+  // records beyond 65535 continue in new batch of same type and id
+  bin_wtr bw;
+  bw.add_hdr( bin::e_upd_price_res, 7 );
+  PC_TEST_CHECK( bw.get_type() == bin::e_upd_price_res );
+  const unsigned num = 70000;
+  for( unsigned i=0; i != num; ++i ) {
+    bin::upd_price_res res;
+    res.idx_ = i;
+    res.err_ = -1;
+    bw.add_rec( res );
+  }
+  net_buf *hd, *tl;
+  bw.detach( hd, tl );
+  std::string buf;
+  while( hd ) {
+    net_buf *nxt = hd->next_;
+    buf.append( hd->buf_, hd->size_ );
+    hd->dealloc();
+    hd = nxt;
+  }
+  size_t rlen = sizeof( bin::upd_price_res );
+  PC_TEST_CHECK( buf.size() == 2*sizeof( bin::hdr ) + num*rlen );
+  const bin::hdr *h1 = (const bin::hdr*)&buf[0];
+  PC_TEST_CHECK( h1->type_ == bin::e_upd_price_res );
+  PC_TEST_CHECK( h1->num_ == 65535 );
+  PC_TEST_CHECK( h1->id_ == 7 );
+  const bin::hdr *h2 = (const bin::hdr*)&buf[sizeof(bin::hdr)+65535*rlen];
+  PC_TEST_CHECK( h2->type_ == bin::e_upd_price_res );
+  PC_TEST_CHECK( h2->num_ == num - 65535 );
+  PC_TEST_CHECK( h2->id_ == 7 );
+  const bin::upd_price_res *last =
+    (const bin::upd_price_res*)&buf[buf.size()-rlen];
+  PC_TEST_CHECK( last->idx_ == num - 1 );
+  bw.reset();
+  PC_TEST_CHECK( bw.get_type() == 0 );
+  PC_TEST_CHECK( bw.size() == 0 );
+}
+
+class test_health_sub : public rpc_sub,
+                        public rpc_sub_i<rpc::get_health>
+{
+public:
+  test_health_sub() : nrecv_( 0 ) {}
+  void on_response( rpc::get_health * ) override { ++nrecv_; }
+  unsigned nrecv_;
+};
+
+static unsigned recv_posts( int fd )
+{
+  char buf[8192];
+  ssize_t len = ::recv( fd, buf, sizeof( buf ), MSG_DONTWAIT );
+  std::string txt( buf, len > 0 ? len : 0 );
+  unsigned num = 0;
+  for( size_t i = txt.find( "POST" ); i != std::string::npos;
+       i = txt.find( "POST", i+1 ) ) {
+    ++num;
+  }
+  return num;
+}
+
+static void send_health( int fd, unsigned id )
+{
+  std::string body = "{\"jsonrpc\":\"2.0\",\"result\":\"ok\",\"id\":" +
+    std::to_string( id ) + "}";
+  std::string msg = "HTTP/1.1 200 OK\r\nContent-Length: " +
+    std::to_string( body.size() ) + "\r\n\r\n" + body;
+  PC_TEST_CHECK( (ssize_t)msg.size() ==
+                 ::send( fd, msg.data(), msg.size(), 0 ) );
+}
+
+void test_http_pool()
+{
+  // two pooled http connections over socket pairs
+  int fd0[2], fd1[2];
+  PC_TEST_CHECK( 0 == ::socketpair( AF_UNIX, SOCK_STREAM, 0, fd0 ) );
+  PC_TEST_CHECK( 0 == ::socketpair( AF_UNIX, SOCK_STREAM, 0, fd1 ) );
+  net_connect c0, c1;
+  c0.set_fd( fd0[0] );
+  c0.set_block( false );
+  c1.set_fd( fd1[0] );
+  c1.set_block( false );
+  rpc_client clnt;
+  clnt.set_http_conn( &c0 );
+  clnt.add_http_conn( &c1 );
+  PC_TEST_CHECK( clnt.get_num_http_conn() == 2 );
+  PC_TEST_CHECK( clnt.get_http_conn() == &c0 );
+
+  // requests alternate between connections with fewest outstanding
+  test_health_sub sub;
+  rpc::get_health req[4];
+  for( unsigned i=0; i != 4; ++i ) {
+    req[i].set_sub( &sub );
+    clnt.send( &req[i] );
+  }
+  c0.poll_send();
+  c1.poll_send();
+  PC_TEST_CHECK( recv_posts( fd0[1] ) == 2 );
+  PC_TEST_CHECK( recv_posts( fd1[1] ) == 2 );
+  PC_TEST_CHECK( clnt.get_http_outstanding( 0 ) == 2 );
+  PC_TEST_CHECK( clnt.get_http_outstanding( 1 ) == 2 );
+
+  // pipelined responses on second connection
+  send_health( fd1[1], req[1].get_id() );
+  send_health( fd1[1], req[3].get_id() );
+  c1.poll_recv();
+  PC_TEST_CHECK( sub.nrecv_ == 2 );
+  PC_TEST_CHECK( clnt.get_http_outstanding( 1 ) == 0 );
+  PC_TEST_CHECK( clnt.get_http_latency( 1 ) > 0 );
+  PC_TEST_CHECK( clnt.get_http_latency( 0 ) == 0 );
+
+  // next request goes to least loaded connection
+  clnt.send( &req[1] );
+  PC_TEST_CHECK( clnt.get_http_outstanding( 1 ) == 1 );
+  PC_TEST_CHECK( clnt.get_http_num_req( 0 ) == 2 );
+  PC_TEST_CHECK( clnt.get_http_num_req( 1 ) == 3 );
+  c0.close();
+  c1.close();
+  ::close( fd0[1] );
+  ::close( fd1[1] );
+}
+
+void test_mcast()
+{
+  // unicast loopback stands in for a multicast group
+  std::string addr = "127.0.0.1:18911";
+  mcast_sub sub;
+  sub.set_addr( addr );
+  PC_TEST_CHECK( sub.init() );
+  mcast_pub pub;
+  pub.set_addr( addr );
+  PC_TEST_CHECK( pub.init() );
+
+  // updates batched across several datagrams
+  mcast::price px;
+  __builtin_memset( &px, 0, sizeof( px ) );
+  for( unsigned i=0; i != 100; ++i ) {
+    px.handle_   = i % 10;
+    px.price_    = i;
+    px.pub_slot_ = 10 + i;
+    pub.add( px );
+  }
+  pub.flush();
+  PC_TEST_CHECK( pub.get_seq() > 1 );
+  sub.poll();
+  PC_TEST_CHECK( sub.get_num_recv() == pub.get_seq() );
+  PC_TEST_CHECK( sub.get_num_upd() == 100 );
+  PC_TEST_CHECK( sub.get_num_gap() == 0 );
+  mcast::price res;
+  PC_TEST_CHECK( sub.get_price( 3, res ) );
+  PC_TEST_CHECK( res.price_ == 93 );
+  PC_TEST_CHECK( !sub.get_price( 10, res ) );
+  PC_TEST_CHECK( sub.get_account( 3 ) == nullptr );
+
+  // snapshots carry account keys without overriding newer updates
+  mcast::snap sn;
+  __builtin_memset( &sn, 0, sizeof( sn ) );
+  sn.px_.handle_   = 3;
+  sn.px_.price_    = 42;
+  sn.px_.pub_slot_ = 5;
+  sn.acc_[0] = 7;
+  pub.add( sn );
+  sn.px_.handle_ = 12;
+  pub.add( sn );
+  pub.flush();
+  sub.poll();
+  PC_TEST_CHECK( sub.get_num_snap() == 2 );
+  PC_TEST_CHECK( sub.get_account( 3 ) && sub.get_account( 3 )[0] == 7 );
+  PC_TEST_CHECK( sub.get_price( 3, res ) && res.price_ == 93 );
+  PC_TEST_CHECK( sub.get_price( 12, res ) && res.price_ == 42 );
+
+  // skipped sequence numbers are reported as gaps
+  mcast::hdr hdr;
+  __builtin_memset( &hdr, 0, sizeof( hdr ) );
+  hdr.magic_   = mcast::magic;
+  hdr.type_    = mcast::e_update;
+  hdr.session_ = pub.get_session();
+  hdr.seq_     = pub.get_seq() + 3;
+  udp_socket usock;
+  PC_TEST_CHECK( usock.init() );
+  ip_addr ip( addr );
+  usock.send( &ip, (const char*)&hdr, sizeof( hdr ) );
+  sub.poll();
+  PC_TEST_CHECK( sub.get_num_gap() == 3 );
+
+  // restarted publisher resets sequence and price table
+  mcast_pub pub2;
+  pub2.set_addr( addr );
+  PC_TEST_CHECK( pub2.init() );
+  PC_TEST_CHECK( pub2.get_session() > pub.get_session() );
+  px.handle_ = 1;
+  px.price_  = 7;
+  pub2.add( px );
+  pub2.flush();
+  sub.poll();
+  PC_TEST_CHECK( sub.get_num_restart() == 1 );
+  PC_TEST_CHECK( sub.get_num_gap() == 3 );
+  PC_TEST_CHECK( sub.get_price( 1, res ) && res.price_ == 7 );
+  PC_TEST_CHECK( !sub.get_price( 3, res ) );
+  PC_TEST_CHECK( sub.get_account( 3 ) == nullptr );
+
+  // late datagrams of previous session are dropped
+  uint64_t num_recv = sub.get_num_recv();
+  px.handle_ = 3;
+  pub.add( px );
+  pub.flush();
+  sub.poll();
+  PC_TEST_CHECK( sub.get_num_recv() == num_recv );
+  PC_TEST_CHECK( !sub.get_price( 3, res ) );
+  PC_TEST_CHECK( sub.get_num_restart() == 1 );
+  usock.close();
+  sub.close();
+}
+
+static std::string recv_ws( int fd )
+{
+  // payloads of all unmasked websocket frames available on socket
+  char buf[65536];
+  ssize_t len = ::recv( fd, buf, sizeof( buf ), MSG_DONTWAIT );
+  std::string res;
+  for( ssize_t i=0; len > 0 && i + 2 <= len; ) {
+    size_t pay = buf[i+1] & 0x7f, hlen = 2;
+    if ( pay == 126 ) {
+      pay = ( (uint8_t)buf[i+2] << 8 ) | (uint8_t)buf[i+3];
+      hlen = 4;
+    }
+    res.append( &buf[i+hlen], pay );
+    i += hlen + pay;
+  }
+  return res;
+}
+
+static std::string user_msg( user& usr, int fd, const std::string& msg )
+{
+  usr.parse_msg( msg.data(), msg.size() );
+  usr.poll_send();
+  return recv_ws( fd );
+}
+
+void test_user_handle()
+{
+  // manager without mapping has no prices so handles are unknown
+  int fd[2];
+  PC_TEST_CHECK( 0 == ::socketpair( AF_UNIX, SOCK_STREAM, 0, fd ) );
+  manager mgr;
+  user usr;
+  usr.set_manager( &mgr );
+  usr.set_fd( fd[0] );
+  usr.set_block( false );
+
+  // well-formed handle is looked up
+  std::string res = user_msg( usr, fd[1],
+      "{\"jsonrpc\":\"2.0\",\"method\":\"update_price\",\"id\":1,"
+      "\"params\":{\"handle\":0,\"price\":1,\"conf\":1,"
+      "\"status\":\"trading\"}}" );
+  PC_TEST_CHECK( res.find( "-32000" ) != std::string::npos );
+
+  // malformed handles are invalid params rather than handle 0
+  const char *bad[] = { "-1", "1.5", "1e2", "\"0\"", "null", "true" };
+  for( const char *hdl: bad ) {
+    res = user_msg( usr, fd[1],
+        std::string( "{\"jsonrpc\":\"2.0\",\"method\":\"update_price\","
+        "\"id\":1,\"params\":{\"handle\":" ) + hdl +
+        ",\"price\":1,\"conf\":1,\"status\":\"trading\"}}" );
+    PC_TEST_CHECK( res.find( "-32602" ) != std::string::npos );
+    res = user_msg( usr, fd[1],
+        std::string( "{\"jsonrpc\":\"2.0\",\"method\":\"subscribe_price\","
+        "\"id\":1,\"params\":{\"handle\":" ) + hdl + "}}" );
+    PC_TEST_CHECK( res.find( "-32602" ) != std::string::npos );
+  }
+
+  // batch reports malformed handles per tuple
+  res = user_msg( usr, fd[1],
+      "{\"jsonrpc\":\"2.0\",\"method\":\"update_prices\",\"id\":1,"
+      "\"params\":[[0,1,1,\"trading\"],[-1,1,1,\"trading\"],"
+      "[true,1,1,\"trading\"],[1.5,1,1,\"trading\"]]}" );
+  PC_TEST_CHECK( res.find( "[0,-32000]" ) != std::string::npos );
+  PC_TEST_CHECK( res.find( "[1,-32602]" ) != std::string::npos );
+  PC_TEST_CHECK( res.find( "[2,-32602]" ) != std::string::npos );
+  PC_TEST_CHECK( res.find( "[3,-32602]" ) != std::string::npos );
+  usr.close();
+  ::close( fd[1] );
+}
+
 int main(int,char**)
 {
   PC_TEST_START
   test_net_buf();
   test_json_wtr();
   test_enc();
+  test_ws_mask();
+  test_read_buf();
+  test_reconnect();
+  test_send_size();
+  test_ws_protocol();
+  test_bin_wtr();
+  test_http_pool();
+  test_mcast();
+  test_user_handle();
   PC_TEST_END
   return 0;
 }
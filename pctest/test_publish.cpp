@@ -256,6 +256,7 @@ void test_publish::on_response( pc::price *sym, uint64_t )
         .add( "price_type", pc::price_type_to_str( sym->get_price_type() ) )
         .add( "num_agg", sym->get_num_agg() )
         .add( "num_sent", sym->get_num_sent() )
+        .add( "num_coalesce", sym->get_num_coalesce() )
         .add( "num_recv", sym->get_num_recv() )
         .add( "num_sub_drop", sym->get_num_sub_drop() )
         .add( "hit_rate", sym->get_hit_rate() )
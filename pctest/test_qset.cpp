@@ -90,10 +90,168 @@ void test_pd()
   PC_TEST_CHECK( pd_gt( n2, n1, dec_fact ) );
 }
 
+// reference digit-by-digit scaling
+static void pd_scale_ref( pd_t *n )
+{
+  int neg = n->v_ < 0L;
+  uint64_t v = neg?-n->v_:n->v_;
+  for( ;v&0xfffffffff0000000UL; v/= 10UL, ++n->e_ );
+  n->v_ = neg ? -v : v;
+}
+
+// reference newton square root
+static void pd_sqrt_ref( pd_t *r, pd_t *val, const uint64_t *f )
+{
+  pd_t t[1], x[1], hlf[1];
+  pd_set( t, val );
+  pd_new( r, 1, 0 );
+  pd_add( x, t, r, f );
+  pd_new( hlf, 5, -1 );
+  pd_mul( x, x, hlf );
+  for(;;) {
+    pd_div( r, t, x );
+    pd_add( r, r, x, f );
+    pd_mul( r, r, hlf );
+    if ( x->v_ == r->v_ ) {
+      break;
+    }
+    pd_set( x, r );
+  }
+}
+
+void test_fast()
+{
+  pc_qset_t *qs = qset_new();
+
+  // single-divide scaling matches digit-by-digit scaling
+  uint64_t seed = 42UL;
+  for( unsigned i=0; i != 100000; ++i ) {
+    seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+    int64_t v = (int64_t)( seed >> ( seed & 63UL ) );
+    if ( seed & 64UL ) v = -v;
+    pd_t n1[1], n2[1];
+    pd_new( n1, v, (int)(seed%19) - 9 );
+    pd_set( n2, n1 );
+    pd_scale( n1 );
+    pd_scale_ref( n2 );
+    PC_TEST_CHECK( n1->v_ == n2->v_ && n1->e_ == n2->e_ );
+  }
+
+  // comparisons match sign of scaled subtraction
+  for( unsigned i=0; i != 100000; ++i ) {
+    seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+    pd_t n1[1], n2[1], r[1];
+    pd_new_scale( n1, (int64_t)(seed>>40) - (1L<<23), (int)(seed%37)-18 );
+    seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+    pd_new_scale( n2, (int64_t)(seed>>40) - (1L<<23), (int)(seed%37)-18 );
+    pd_sub( r, n1, n2, qs->fact_ );
+    PC_TEST_CHECK( pd_lt( n1, n2, qs->fact_ ) == ( r->v_ < 0L ) );
+    PC_TEST_CHECK( pd_gt( n1, n2, qs->fact_ ) == ( r->v_ > 0L ) );
+  }
+
+  // max weight table matches 1/sqrt(n)
+  pd_t one[1];
+  pd_new( one, 100000000L, -8 );
+  for( uint32_t n=1; n <= PC_COMP_SIZE; ++n ) {
+    pd_t w[1];
+    pd_new( w, n, 0 );
+    pd_sqrt_ref( w, w, qs->fact_ );
+    pd_div( w, one, w );
+    PC_TEST_CHECK( w->v_ == qs->wmax_[n].v_ && w->e_ == qs->wmax_[n].e_ );
+  }
+}
+
+// reference linear scan weighted percentile
+static void wgt_ptile_ref(
+    pd_t *res, pd_t *prices, pd_t *ptile, pc_qset_t *qs )
+{
+  pd_t *cumwgt = qs->cumwgt_;
+  uint32_t i =0, num = qs->num_;
+  for( ; i != num && pd_lt( &cumwgt[i], ptile, qs->fact_ ); ++i );
+  if ( i == num ) {
+    pd_set( res, &prices[num-1] );
+  } else if ( i == 0 ) {
+    pd_set( res, &prices[0] );
+  } else {
+    pd_t t1[1], t2[1];
+    pd_sub( t1, &prices[i], &prices[i-1], qs->fact_ );
+    pd_sub( t2, ptile, &cumwgt[i-1], qs->fact_ );
+    pd_mul( t1, t1, t2 );
+    pd_sub( t2, &cumwgt[i], &cumwgt[i-1], qs->fact_ );
+    pd_div( t1, t1, t2 );
+    pd_add( res, &prices[i-1], t1, qs->fact_ );
+  }
+}
+
+void test_sort()
+{
+  // quote sort matches stable sort of indices including ties
+  uint64_t seed = 7UL;
+  for( unsigned it=0; it != 10000; ++it ) {
+    seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+    uint32_t num = 1 + (seed>>33) % PC_COMP_SIZE;
+    uint64_t rng = 1UL << ( (seed>>40) % 40 );
+    int64_t prc[PC_COMP_SIZE];
+    uint32_t idx[PC_COMP_SIZE], ref[PC_COMP_SIZE];
+    for( uint32_t i=0; i != num; ++i ) {
+      seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+      prc[i] = (int64_t)( (seed>>20) % rng ) - (int64_t)( rng/2 );
+      idx[i] = i;
+      uint32_t j = i;
+      for( ; j > 0 && prc[ref[j-1]] > prc[i]; --j ) {
+        ref[j] = ref[j-1];
+      }
+      ref[j] = i;
+    }
+    srt_quotes( prc, idx, num );
+    for( uint32_t i=0; i != num; ++i ) {
+      PC_TEST_CHECK( idx[i] == ref[i] );
+      PC_TEST_CHECK( i == 0 || prc[i-1] <= prc[i] );
+    }
+  }
+}
+
+void test_ptile()
+{
+  // binary search percentile matches linear scan on random quotes
+  uint64_t seed = 11UL;
+  pc_price_t px[1];
+  for( unsigned it=0; it != 2000; ++it ) {
+    __builtin_memset( px, 0, sizeof( pc_price_t ) );
+    seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+    px->expo_ = -(int32_t)( (seed>>33) % 10 );
+    px->num_  = 2 + (seed>>40) % ( PC_COMP_SIZE - 1 );
+    uint64_t rng = 1UL << ( 1 + (seed>>20) % 40 );
+    for( uint32_t i=0; i != px->num_; ++i ) {
+      seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+      pc_price_comp_t *ptr = &px->comp_[i];
+      ptr->latest_.status_   = PC_STATUS_TRADING;
+      ptr->latest_.price_    = (int64_t)( (seed>>20) % rng );
+      ptr->latest_.conf_     = 1UL + (seed>>8) % ( 1UL << ((seed>>2)%40) );
+      ptr->latest_.pub_slot_ = 1000UL - (seed>>50) % 4;
+    }
+    upd_aggregate( px, 1001UL );
+    pc_qset_t *qs = (pc_qset_t*)PC_HEAP_START;
+    pd_t ptile[1], r1[1], r2[1];
+    for( int64_t p = 5; p < 100; p += 5 ) {
+      pd_new( ptile, p, -2 );
+      wgt_ptile( r1, qs->iprice_, ptile, qs );
+      wgt_ptile_ref( r2, qs->iprice_, ptile, qs );
+      PC_TEST_CHECK( r1->v_ == r2->v_ && r1->e_ == r2->e_ );
+      wgt_ptile( r1, qs->uprice_, ptile, qs );
+      wgt_ptile_ref( r2, qs->uprice_, ptile, qs );
+      PC_TEST_CHECK( r1->v_ == r2->v_ && r1->e_ == r2->e_ );
+    }
+  }
+}
+
 void test_qs()
 {
   PC_TEST_START
   test_pd();
+  test_fast();
+  test_sort();
+  test_ptile();
   PC_TEST_END
 }
 
@@ -1,6 +1,7 @@
 #!/bin/bash
 
-BIN=./test_qset
+BIN=${1:-./test_qset}
+DIR=$(dirname $0)
 TESTS=(
   test_qset_1.json
   test_qset_2.json
@@ -34,5 +35,5 @@ TESTS=(
   test_qset_30.json
 )
 for i in ${TESTS[@]} ; do
-  $BIN ../pctest/$i
+  $BIN $DIR/$i
 done
@@ -1,13 +1,22 @@
 #include <pc/key_pair.hpp>
+#include <pc/leader_route.hpp>
 #include <pc/misc.hpp>
 #include <pc/log.hpp>
+#include <pc/manager.hpp>
 #include <pc/request.hpp>
+#include <pc/rpc_feed.hpp>
+#include <pc/snapshot.hpp>
+#include <pc/shm_price.hpp>
+#include <pc/shm_upd.hpp>
 #include "test_error.hpp"
 #include <math.h>
 #include <iostream>
 #include <vector>
 #include <sstream>
 #include <algorithm>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <zstd.h>
 
 using namespace pc;
 
@@ -37,6 +46,28 @@ void test_key()
     PC_TEST_CHECK( pk.data()[i] == pk2.data()[i] );
   }
 
+  // check cached base58 text follows key changes
+  pub_key_b58 ck( pk );
+  PC_TEST_CHECK( ck.get_text() == str( pktxt ) );
+  PC_TEST_CHECK( ck.get_text().str_ == ck.get_text().str_ );
+  ck.zero();
+  PC_TEST_CHECK( ck.get_text() == str( "11111111111111111111111111111111" ) );
+  ck = pk;
+  PC_TEST_CHECK( ck.get_text() == str( pktxt ) );
+  {
+    json_wtr jw;
+    jw.add_val( json_wtr::e_obj );
+    jw.add_key( "account", ck );
+    jw.add_key( "key", pk );
+    jw.pop();
+    net_buf *hd, *tl;
+    jw.detach( hd, tl );
+    std::string jtxt( hd->buf_, hd->size_ );
+    hd->dealloc();
+    PC_TEST_CHECK( jtxt == std::string( "{\"account\":\"" ) + pktxt +
+        "\",\"key\":\"" + pktxt + "\"}" );
+  }
+
   // check message signing and encoding
   static const char sigtxt[] = "3LEWGZ5K88RqFnftjqyzaFm4AdYkwnGvJhKb13dVEa9uLnoDUif5B3esZyQ8dwxtx44PQZqkvhqH4HZUMi5PjTHQ";
 
@@ -97,6 +128,20 @@ void test_log()
     .end();
 }
 
+void test_log_limit()
+{
+  log_limit lim( 1, 2 );
+  PC_TEST_CHECK( lim.allow() );
+  PC_TEST_CHECK( lim.allow() );
+  PC_TEST_CHECK( !lim.allow() );
+  PC_TEST_CHECK( !lim.allow() );
+  PC_TEST_CHECK( lim.swap_suppressed() == 2 );
+  PC_TEST_CHECK( lim.swap_suppressed() == 0 );
+  lim.set_rate( 1000000000, 1 );
+  PC_TEST_CHECK( lim.allow() );
+  PC_TEST_CHECK( log_build<PC_LOG_ERR_LVL>::enabled );
+}
+
 class test_request : public request
 {
 public:
@@ -176,12 +221,574 @@ void test_request_sub()
   PC_TEST_CHECK( sub1.check( "r1", p1_3 ) );
 }
 
+template<unsigned N>
+void test_base58_fixed( uint64_t& seed )
+{
+  uint8_t src[N], gen[N*2+2], fix[N*2+2], gtxt[N*2], ftxt[N*2];
+  for( unsigned it=0; it != 20000; ++it ) {
+    // random keys with occasional runs of leading zero bytes
+    for( unsigned i=0; i != N; ++i ) {
+      seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+      src[i] = (uint8_t)( seed >> 33 );
+    }
+    unsigned nz = it%8 == 0 ? (unsigned)( seed >> 40 ) % ( N + 1 ) : 0;
+    __builtin_memset( src, 0, nz );
+    if ( it%16 == 1 ) __builtin_memset( &src[N/2], 0xff, N/2 );
+    int glen = enc_base58( src, N, gtxt, sizeof( gtxt ) );
+    int flen = enc_base58_fixed<N>( src, ftxt, sizeof( ftxt ) );
+    PC_TEST_CHECK( glen == flen );
+    PC_TEST_CHECK( 0 == __builtin_memcmp( gtxt, ftxt, glen + 1 ) );
+
+    // round trip and decoding of truncated or corrupted text
+    __builtin_memset( gen, 0xa5, sizeof( gen ) );
+    __builtin_memset( fix, 0xa5, sizeof( fix ) );
+    int tlen = glen - ( it%32 == 2 ? 1 : 0 );
+    if ( it%32 == 3 ) ftxt[it%glen] = '0';
+    __builtin_memcpy( gtxt, ftxt, glen );
+    int gdec = dec_base58( gtxt, tlen, gen );
+    int fdec = dec_base58_fixed<N>( ftxt, tlen, fix );
+    PC_TEST_CHECK( gdec == fdec );
+    PC_TEST_CHECK( 0 == __builtin_memcmp( gen, fix, sizeof( gen ) ) );
+    if ( it%32 > 3 ) {
+      PC_TEST_CHECK( 0 == __builtin_memcmp( src, fix, N ) );
+    }
+  }
+  // output buffer too small
+  PC_TEST_CHECK( 0 == enc_base58_fixed<N>( src, ftxt, 8 ) );
+}
+
+void test_base58()
+{
+  uint64_t seed = 42UL;
+  test_base58_fixed<32>( seed );
+  test_base58_fixed<64>( seed );
+}
+
+void test_upd_prices()
+{
+  // pack as many price updates as fit in one transaction
+  key_pair pk;
+  pk.gen();
+  key_cache ck;
+  ck.set( pk );
+  pub_key gkey, akey[rpc::upd_prices::max_num+1];
+  hash bhash;
+  bhash.zero();
+  gkey.init_from_buf( bhash.data() );
+  rpc::upd_price req[rpc::upd_prices::max_num+1];
+  rpc::upd_prices txp;
+  for( unsigned i=0; i != rpc::upd_prices::max_num+1; ++i ) {
+    uint8_t buf[pub_key::len] = { (uint8_t)(i+1) };
+    akey[i].init_from_buf( buf );
+    req[i].set_publish( &pk );
+    req[i].set_pubcache( &ck );
+    req[i].set_program( &gkey );
+    req[i].set_account( &akey[i] );
+    req[i].set_block_hash( &bhash );
+    req[i].set_price( 100+i, 10, symbol_status::e_trading, 42, false );
+    PC_TEST_CHECK( txp.add( &req[i] ) == ( i != rpc::upd_prices::max_num ) );
+  }
+  PC_TEST_CHECK( req[0].get_is_pending() );
+  PC_TEST_CHECK( !req[rpc::upd_prices::max_num].get_is_pending() );
+  PC_TEST_CHECK( txp.add( &req[0] ) );
+  PC_TEST_CHECK( txp.get_num() == rpc::upd_prices::max_num );
+  PC_TEST_CHECK( rpc::upd_prices::get_size( txp.get_num() ) <=
+                 PC_TX_MAX_SIZE );
+  PC_TEST_CHECK( rpc::upd_prices::get_size( txp.get_num() + 1 ) >
+                 PC_TX_MAX_SIZE );
+
+  // check layout and signature of packed transaction
+  net_wtr wtr;
+  txp.build( wtr );
+  net_buf *hd, *tl;
+  wtr.detach( hd, tl );
+  tx_hdr *hdr = (tx_hdr*)hd->buf_;
+  size_t tlen = rpc::upd_prices::get_size( txp.get_num() );
+  PC_TEST_CHECK( hd->size_ == sizeof( tx_hdr ) + tlen );
+  PC_TEST_CHECK( hdr->size_ == hd->size_ );
+  const uint8_t *tx = (const uint8_t*)&hdr[1];
+  PC_TEST_CHECK( tx[0] == 1 );
+  const uint8_t *msg = &tx[1+signature::len];
+  PC_TEST_CHECK( msg[3] == txp.get_num() + 3 );
+  signature sig;
+  sig.init_from_buf( &tx[1] );
+  PC_TEST_CHECK( sig.verify( msg, tlen - 1 - signature::len, pk ) );
+  const uint8_t *ins = &msg[4+(txp.get_num()+3)*pub_key::len+hash::len];
+  PC_TEST_CHECK( ins[0] == txp.get_num() );
+  const uint8_t *last = &ins[1+(txp.get_num()-1)*46];
+  PC_TEST_CHECK( last[0] == txp.get_num() + 2 );
+  PC_TEST_CHECK( last[3] == txp.get_num() );
+  PC_TEST_CHECK( last[4] == txp.get_num() + 1 );
+  cmd_upd_price *cmd = (cmd_upd_price*)&last[6];
+  PC_TEST_CHECK( cmd->price_ == 100 + txp.get_num() - 1 );
+  hd->dealloc();
+
+  // single update is sent as a regular upd_price transaction
+  txp.reset();
+  PC_TEST_CHECK( !req[0].get_is_pending() );
+  txp.set_slot( 43 );
+  PC_TEST_CHECK( txp.add( &req[0] ) );
+  net_wtr w1, w2;
+  txp.build( w1 );
+  req[0].build( w2 );
+  PC_TEST_CHECK( w1.size() == w2.size() );
+  PC_TEST_CHECK( w1.size() == sizeof( tx_hdr ) +
+                 rpc::upd_prices::get_size( 1 ) );
+
+  // second update in the same slot is held back so that it cannot fail
+  // the other instructions of its transaction
+  txp.reset();
+  req[0].set_price( 200, 10, symbol_status::e_trading, 43, false );
+  PC_TEST_CHECK( txp.add( &req[0] ) );
+  PC_TEST_CHECK( txp.add( &req[1] ) );
+  PC_TEST_CHECK( req[0].get_is_pending() );
+  PC_TEST_CHECK( txp.get_num() == 1 );
+  PC_TEST_CHECK( txp.get_num_held() == 1 );
+  PC_TEST_CHECK( !txp.release() );
+  net_wtr w3;
+  txp.build( w3 );
+  txp.reset();
+  PC_TEST_CHECK( req[0].get_is_pending() );
+
+  // held update is restamped and sent in the next slot
+  req[0].set_price( 201, 10, symbol_status::e_trading, 43, false );
+  PC_TEST_CHECK( txp.add( &req[0] ) );
+  PC_TEST_CHECK( txp.get_num_held() == 1 );
+  txp.set_slot( 44 );
+  PC_TEST_CHECK( txp.release() );
+  PC_TEST_CHECK( txp.get_num() == 1 );
+  PC_TEST_CHECK( txp.get_num_held() == 0 );
+  net_wtr w4;
+  txp.build( w4 );
+  w4.detach( hd, tl );
+  cmd = (cmd_upd_price*)&hd->buf_[hd->size_ - sizeof( cmd_upd_price )];
+  PC_TEST_CHECK( cmd->price_ == 201 );
+  PC_TEST_CHECK( cmd->pub_slot_ == 44 );
+  hd->dealloc();
+  txp.reset();
+  PC_TEST_CHECK( !req[0].get_is_pending() );
+}
+
+void test_feed_stats()
+{
+  // win rate and lag behind winning feed
+  feed_stats st;
+  PC_TEST_CHECK( st.get_win_rate() == 0. );
+  st.add_win();
+  st.add_loss( 800 );
+  st.add_loss( 0 );
+  st.add_win();
+  PC_TEST_CHECK( st.get_num_upd() == 4 );
+  PC_TEST_CHECK( st.get_num_win() == 2 );
+  PC_TEST_CHECK( st.get_win_rate() == 50. );
+  PC_TEST_CHECK( st.get_lag() == 800 );
+  st.add_loss( 1600 );
+  PC_TEST_CHECK( st.get_lag() == 900 );
+}
+
+void test_feed_race()
+{
+  // first copy of an account update per slot wins
+  pub_key a, b;
+  a.init_from_text( std::string( "11111111111111111111111111111112" ) );
+  b.init_from_text( std::string( "11111111111111111111111111111113" ) );
+  feed_race rc;
+  feed_stats f1, f2;
+  PC_TEST_CHECK( rc.add( a, 10, 1000, f1 ) );
+  PC_TEST_CHECK( !rc.add( a, 10, 1300, f2 ) );
+  PC_TEST_CHECK( f2.get_lag() == 300 );
+
+  // older slot is dropped without lag
+  PC_TEST_CHECK( !rc.add( a, 9, 1400, f2 ) );
+  PC_TEST_CHECK( f2.get_lag() == 300 );
+
+  // accounts race independently
+  PC_TEST_CHECK( rc.add( b, 10, 1500, f2 ) );
+  PC_TEST_CHECK( rc.add( a, 11, 2000, f2 ) );
+  PC_TEST_CHECK( !rc.add( a, 11, 2100, f1 ) );
+  PC_TEST_CHECK( f1.get_num_upd() == 2 );
+  PC_TEST_CHECK( f1.get_num_win() == 1 );
+  PC_TEST_CHECK( f1.get_lag() == 100 );
+  PC_TEST_CHECK( f2.get_num_upd() == 4 );
+  PC_TEST_CHECK( f2.get_num_win() == 2 );
+  PC_TEST_CHECK( f2.get_lag() == 300 );
+}
+
+void test_ws_failover()
+{
+  // full reconnect without a live feed
+  ws_failover wf;
+  int64_t ts = 10L * PC_NSECS_IN_SEC;
+  PC_TEST_CHECK( wf.check( false, false, true, ts ) ==
+                 ws_failover::e_reconnect_all );
+  PC_TEST_CHECK( !wf.get_is_fail() );
+
+  // otherwise reconnect websocket at most once per second
+  PC_TEST_CHECK( wf.check( true, false, true, ts ) ==
+                 ws_failover::e_connect );
+  PC_TEST_CHECK( wf.get_is_fail() );
+  ts += PC_NSECS_IN_SEC / 2;
+  PC_TEST_CHECK( wf.check( true, true, false, ts ) ==
+                 ws_failover::e_wait );
+  PC_TEST_CHECK( wf.check( true, false, true, ts ) ==
+                 ws_failover::e_wait );
+  ts += PC_NSECS_IN_SEC;
+  PC_TEST_CHECK( wf.check( true, false, true, ts ) ==
+                 ws_failover::e_connect );
+
+  // resubscribe once reconnected
+  PC_TEST_CHECK( wf.check( true, false, false, ts ) ==
+                 ws_failover::e_resubscribe );
+  PC_TEST_CHECK( !wf.get_is_fail() );
+
+  // feeds lost during failover
+  PC_TEST_CHECK( wf.check( true, false, true, ts ) ==
+                 ws_failover::e_connect );
+  PC_TEST_CHECK( wf.check( false, true, false, ts ) ==
+                 ws_failover::e_reconnect_all );
+  PC_TEST_CHECK( !wf.get_is_fail() );
+}
+
+void test_leader_route()
+{
+  // leaders a,a,b,c,a,d from slot 100 where c has no tpu address
+  std::string key[4];
+  for( unsigned i=0; i != 4; ++i ) {
+    uint8_t buf[32];
+    __builtin_memset( buf, 'a' + i, sizeof( buf ) );
+    pub_key pk;
+    pk.init_from_buf( buf );
+    pk.enc_base58( key[i] );
+  }
+  std::string ltxt = "{\"result\":[\"" + key[0] + "\",\"" + key[0] +
+    "\",\"" + key[1] + "\",\"" + key[2] + "\",\"" + key[0] +
+    "\",\"" + key[3] + "\"]}";
+  std::string ctxt = "{\"result\":["
+    "{\"pubkey\":\"" + key[0] + "\",\"tpu\":\"127.0.0.1:1001\"},"
+    "{\"pubkey\":\"" + key[1] + "\",\"tpu\":\"127.0.0.1:1002\"},"
+    "{\"pubkey\":\"" + key[3] + "\",\"tpu\":\"127.0.0.1:1004\"}]}";
+  rpc::get_slot_leaders lreq;
+  rpc::get_cluster_nodes creq;
+  jtree jt;
+  lreq.set_slot( 100 );
+  lreq.set_limit( 6 );
+  jt.parse( ltxt.c_str(), ltxt.size() );
+  lreq.response( jt );
+  jt.parse( ctxt.c_str(), ctxt.size() );
+  creq.response( jt );
+  ip_addr a1( "127.0.0.1:1001" ), a2( "127.0.0.1:1002" );
+  ip_addr a4( "127.0.0.1:1004" );
+
+  // current slot is kept across rebuilds
+  leader_route rt;
+  rt.set_window( 1, 2 );
+  rt.set_slot( 103 );
+  rt.build( &lreq, &creq );
+  PC_TEST_CHECK( rt.get_first_slot() == 100 );
+  PC_TEST_CHECK( rt.get_num_slot() == 6 );
+  PC_TEST_CHECK( rt.get_num_addr() == 3 );
+  PC_TEST_CHECK( rt.get_num_missing() == 1 );
+  PC_TEST_CHECK( rt.get_num_dest() == 3 );
+  PC_TEST_CHECK( *rt.get_dest( 0 ) == a2 );
+  PC_TEST_CHECK( *rt.get_dest( 1 ) == a1 );
+  PC_TEST_CHECK( *rt.get_dest( 2 ) == a4 );
+
+  // repeated leaders within window are sent to once
+  rt.set_slot( 100 );
+  PC_TEST_CHECK( rt.get_num_dest() == 2 );
+  PC_TEST_CHECK( *rt.get_dest( 0 ) == a1 );
+  PC_TEST_CHECK( *rt.get_dest( 1 ) == a2 );
+
+  // missing leader address is skipped
+  rt.set_slot( 104 );
+  PC_TEST_CHECK( rt.get_num_dest() == 2 );
+  PC_TEST_CHECK( *rt.get_dest( 0 ) == a1 );
+  PC_TEST_CHECK( *rt.get_dest( 1 ) == a4 );
+  rt.set_slot( 105 );
+  PC_TEST_CHECK( rt.get_num_dest() == 2 );
+
+  // slots outside of table have no destinations
+  rt.set_slot( 106 );
+  PC_TEST_CHECK( rt.get_num_dest() == 0 );
+  rt.set_slot( 99 );
+  PC_TEST_CHECK( rt.get_num_dest() == 0 );
+  rt.set_slot( 0 );
+  PC_TEST_CHECK( rt.get_num_dest() == 0 );
+
+  // reset discards table
+  rt.set_slot( 103 );
+  rt.reset();
+  PC_TEST_CHECK( rt.get_num_dest() == 0 );
+  PC_TEST_CHECK( rt.get_num_slot() == 0 );
+  PC_TEST_CHECK( rt.get_num_addr() == 0 );
+  rt.set_slot( 103 );
+  PC_TEST_CHECK( rt.get_num_dest() == 0 );
+}
+
+void test_snapshot()
+{
+  // save and reload account images with update slots
+  pc_map_table_t *tab = new pc_map_table_t;
+  __builtin_memset( tab, 0, sizeof( pc_map_table_t ) );
+  tab->magic_ = PC_MAGIC;
+  tab->ver_   = PC_VERSION;
+  tab->type_  = PC_ACCTYPE_MAPPING;
+  tab->num_   = 1;
+  tab->size_  = sizeof( pc_map_table_t ) - sizeof( tab->prod_ ) +
+    sizeof( pc_pub_key_t );
+  tab->prod_[0].k8_[0] = 7UL;
+  pc_price_t *px = new pc_price_t;
+  __builtin_memset( px, 0, sizeof( pc_price_t ) );
+  px->magic_ = PC_MAGIC;
+  px->type_  = PC_ACCTYPE_PRICE;
+  px->size_  = sizeof( pc_price_t ) - sizeof( px->comp_ ) + 3;
+  px->expo_  = -5;
+  pc_pub_key_t k1, k2;
+  __builtin_memset( &k1, 1, sizeof( k1 ) );
+  __builtin_memset( &k2, 2, sizeof( k2 ) );
+  std::string file = "/tmp/test_snapshot." + std::to_string( getpid() );
+  snapshot wtr;
+  wtr.set_file( file );
+  wtr.add( 11UL, &k1, (pc_acc_t*)tab );
+  wtr.add( 12UL, &k2, (pc_acc_t*)px );
+  PC_TEST_CHECK( wtr.get_num() == 2 );
+  PC_TEST_CHECK( wtr.save() );
+  PC_TEST_CHECK( wtr.get_num() == 0 );
+
+  snapshot rdr;
+  rdr.set_file( file );
+  PC_TEST_CHECK( rdr.init() );
+  PC_TEST_CHECK( rdr.get_next() );
+  PC_TEST_CHECK( rdr.get_slot() == 11UL );
+  PC_TEST_CHECK( pc_pub_key_equal( rdr.get_account(), &k1 ) );
+  pc_map_table_t *rtab;
+  PC_TEST_CHECK( rdr.get_data_ref( rtab ) == sizeof( pc_map_table_t ) );
+  PC_TEST_CHECK( rtab->num_ == 1 && rtab->prod_[0].k8_[0] == 7UL );
+  PC_TEST_CHECK( rtab->prod_[1].k8_[0] == 0UL );
+  PC_TEST_CHECK( rdr.get_next() );
+  PC_TEST_CHECK( rdr.get_slot() == 12UL );
+  PC_TEST_CHECK( rdr.get_update()->type_ == PC_ACCTYPE_PRICE );
+  pc_price_t *rpx = new pc_price_t;
+  rdr.get_data_val( rpx );
+  PC_TEST_CHECK( rpx->expo_ == -5 && rpx->size_ == px->size_ );
+  PC_TEST_CHECK( !rdr.get_next() );
+  ::unlink( file.c_str() );
+  delete rpx;
+  delete px;
+  delete tab;
+}
+
+static pc_price_t *new_price_image( int32_t expo, uint64_t pub_slot )
+{
+  pc_price_t *px = new pc_price_t;
+  __builtin_memset( px, 0, sizeof( pc_price_t ) );
+  px->magic_ = PC_MAGIC;
+  px->ver_   = PC_VERSION;
+  px->type_  = PC_ACCTYPE_PRICE;
+  px->size_  = sizeof( pc_price_t ) - sizeof( px->comp_ );
+  px->expo_  = expo;
+  px->agg_.pub_slot_ = pub_slot;
+  return px;
+}
+
+static std::string recv_rpc( int fd )
+{
+  char buf[8192];
+  ssize_t len = ::recv( fd, buf, sizeof( buf ), MSG_DONTWAIT );
+  return std::string( buf, len > 0 ? len : 0 );
+}
+
+static void send_account( int fd, uint64_t id, uint64_t slot,
+                          const pc_price_t *px )
+{
+  // base64+zstd encoded getAccountInfo response
+  std::vector<char> zbuf( ZSTD_compressBound( sizeof( pc_price_t ) ) );
+  size_t zlen = ZSTD_compress(
+      &zbuf[0], zbuf.size(), px, sizeof( pc_price_t ), 1 );
+  std::vector<uint8_t> bbuf( enc_base64_len( zlen ) + 1 );
+  int blen = enc_base64( (const uint8_t*)&zbuf[0], zlen, &bbuf[0] );
+  std::string body = "{\"jsonrpc\":\"2.0\",\"result\":{\"context\":"
+    "{\"slot\":" + std::to_string( slot ) + "},\"value\":{\"data\":[\"" +
+    std::string( (const char*)&bbuf[0], blen ) + "\",\"base64+zstd\"],"
+    "\"executable\":false,\"lamports\":1,\"owner\":\"\",\"rentEpoch\":0}},"
+    "\"id\":" + std::to_string( id ) + "}";
+  std::string msg = "HTTP/1.1 200 OK\r\nContent-Length: " +
+    std::to_string( body.size() ) + "\r\n\r\n" + body;
+  PC_TEST_CHECK( (ssize_t)msg.size() ==
+                 ::send( fd, msg.data(), msg.size(), 0 ) );
+}
+
+void test_resync()
+{
+  // price account on rpc client over a socket pair
+  int fd[2];
+  PC_TEST_CHECK( 0 == ::socketpair( AF_UNIX, SOCK_STREAM, 0, fd ) );
+  net_connect hc;
+  hc.set_fd( fd[0] );
+  hc.set_block( false );
+  rpc_client clnt;
+  clnt.set_http_conn( &hc );
+  manager mgr;
+  pub_key sacc, pacc;
+  sacc.init_from_text( std::string( "11111111111111111111111111111112" ) );
+  pacc.init_from_text( std::string( "11111111111111111111111111111113" ) );
+  product prod( sacc );
+  price px( pacc, &prod );
+  px.set_manager( &mgr );
+  px.set_rpc_client( &clnt );
+
+  // account image received at slot 20
+  std::string file = "/tmp/test_resync." + std::to_string( getpid() );
+  pc_price_t *img = new_price_image( -5, 18 );
+  snapshot wtr;
+  wtr.set_file( file );
+  wtr.add( 20UL, (const pc_pub_key_t*)pacc.data(), (pc_acc_t*)img );
+  PC_TEST_CHECK( wtr.save() );
+  snapshot rdr;
+  rdr.set_file( file );
+  PC_TEST_CHECK( rdr.init() );
+  PC_TEST_CHECK( rdr.get_next() );
+  px.on_snapshot( &rdr );
+  ::unlink( file.c_str() );
+  PC_TEST_CHECK( px.get_recv_slot() == 20 );
+  PC_TEST_CHECK( px.get_price_exponent() == -5 );
+
+  // account updated at or after resync point is not refetched
+  PC_TEST_CHECK( !px.resync( 20 ) );
+  hc.poll_send();
+  PC_TEST_CHECK( recv_rpc( fd[1] ).empty() );
+
+  // stale account is refetched
+  PC_TEST_CHECK( px.resync( 21 ) );
+  hc.poll_send();
+  std::string req = recv_rpc( fd[1] );
+  PC_TEST_CHECK( req.find( "getAccountInfo" ) != std::string::npos );
+  size_t ipos = req.find( "\"id\":" );
+  PC_TEST_CHECK( ipos != std::string::npos );
+  uint64_t id = std::stoul( req.substr( ipos + 5 ) );
+
+  // reply older than latest subscription update is ignored
+  pc_price_t *old = new_price_image( -7, 16 );
+  send_account( fd[1], id, 15, old );
+  hc.poll_recv();
+  PC_TEST_CHECK( px.get_recv_slot() == 20 );
+  PC_TEST_CHECK( px.get_price_exponent() == -5 );
+  PC_TEST_CHECK( !px.get_is_err() );
+
+  // newer reply replaces image
+  PC_TEST_CHECK( px.resync( 21 ) );
+  hc.poll_send();
+  req = recv_rpc( fd[1] );
+  ipos = req.find( "\"id\":" );
+  PC_TEST_CHECK( ipos != std::string::npos );
+  id = std::stoul( req.substr( ipos + 5 ) );
+  send_account( fd[1], id, 22, old );
+  hc.poll_recv();
+  PC_TEST_CHECK( px.get_recv_slot() == 22 );
+  PC_TEST_CHECK( px.get_price_exponent() == -7 );
+  PC_TEST_CHECK( !px.resync( 21 ) );
+  hc.close();
+  ::close( fd[1] );
+  delete old;
+  delete img;
+}
+
+void test_shm_price()
+{
+  // seqlock price records and update ring
+  std::string file = "/tmp/test_shm_price." + std::to_string( getpid() );
+  shm_price_wtr wtr;
+  wtr.set_file( file );
+  wtr.set_max_price( 8 );
+  wtr.set_ring_size( 4 );
+  PC_TEST_CHECK( wtr.init() );
+  shm_price_rdr rdr;
+  rdr.set_file( file );
+  PC_TEST_CHECK( rdr.init() );
+  shm::price rec, res;
+  __builtin_memset( &rec, 0, sizeof( rec ) );
+  uint32_t hdl = 0;
+  PC_TEST_CHECK( !rdr.get_next( hdl ) );
+  PC_TEST_CHECK( !rdr.get_price( 0, res ) );
+  rec.price_ = 100;
+  wtr.update( 3, rec );
+  rec.price_ = 101;
+  wtr.update( 1, rec );
+  wtr.update( 9, rec );
+  PC_TEST_CHECK( rdr.get_num_price() == 4 );
+  PC_TEST_CHECK( rdr.get_next( hdl ) && hdl == 3 );
+  PC_TEST_CHECK( rdr.get_price( hdl, res ) && res.price_ == 100 );
+  PC_TEST_CHECK( res.seq_ == 2 );
+  PC_TEST_CHECK( rdr.get_next( hdl ) && hdl == 1 );
+  PC_TEST_CHECK( rdr.get_price( hdl, res ) && res.price_ == 101 );
+  PC_TEST_CHECK( !rdr.get_price( 2, res ) );
+  PC_TEST_CHECK( !rdr.get_next( hdl ) );
+
+  // reader that falls behind the ring skips to its head
+  for( unsigned i=0; i != 6; ++i ) {
+    wtr.update( i, rec );
+  }
+  PC_TEST_CHECK( !rdr.get_next( hdl ) );
+  PC_TEST_CHECK( rdr.get_num_overrun() == 1 );
+  wtr.update( 5, rec );
+  PC_TEST_CHECK( rdr.get_next( hdl ) && hdl == 5 );
+  ::unlink( file.c_str() );
+}
+
+void test_shm_upd()
+{
+  // publisher updates through shared-memory ring
+  std::string file = "/tmp/test_shm_upd." + std::to_string( getpid() );
+  shm_upd_rdr rdr;
+  rdr.set_file( file );
+  rdr.set_ring_size( 4 );
+  PC_TEST_CHECK( rdr.init() );
+  shm_upd_wtr wtr;
+  wtr.set_file( file );
+  PC_TEST_CHECK( wtr.init() );
+  shm::upd upd;
+  PC_TEST_CHECK( !rdr.get_next( upd ) );
+  for( unsigned i=0; i != 4; ++i ) {
+    PC_TEST_CHECK( wtr.add( i, 100+i, 5, 1 ) );
+  }
+  PC_TEST_CHECK( !wtr.add( 4, 104, 5, 1 ) );
+  PC_TEST_CHECK( !rdr.set_wait() );
+  rdr.reset_wait();
+  for( unsigned i=0; i != 4; ++i ) {
+    PC_TEST_CHECK( rdr.get_next( upd ) );
+    PC_TEST_CHECK( upd.handle_ == i && upd.price_ == 100+i );
+    PC_TEST_CHECK( upd.conf_ == 5 && upd.status_ == 1 );
+  }
+  PC_TEST_CHECK( !rdr.get_next( upd ) );
+
+  // blocked reader is woken through fifo
+  PC_TEST_CHECK( rdr.set_wait() );
+  PC_TEST_CHECK( wtr.add( 7, 107, 5, 1 ) );
+  char c;
+  PC_TEST_CHECK( ::read( rdr.get_fd(), &c, 1 ) == 1 );
+  rdr.reset_wait();
+  PC_TEST_CHECK( rdr.get_next( upd ) && upd.handle_ == 7 );
+  ::unlink( file.c_str() );
+  ::unlink( ( file + ".wake" ).c_str() );
+}
+
 int main(int,char**)
 {
   PC_TEST_START
   test_key();
+  test_base58();
   test_log();
+  test_log_limit();
   test_request_sub();
+  test_upd_prices();
+  test_feed_stats();
+  test_feed_race();
+  test_ws_failover();
+  test_leader_route();
+  test_snapshot();
+  test_resync();
+  test_shm_price();
+  test_shm_upd();
   PC_TEST_END
   return 0;
 }
@@ -169,6 +169,7 @@ typedef struct pc_qset
   pd_t      cumwgt_[PC_COMP_SIZE];
   uint64_t  decay_[1+PC_MAX_SEND_LATENCY];
   uint64_t  fact_[PC_FACTOR_SIZE];
+  pd_t      wmax_[1+PC_COMP_SIZE];
   uint32_t  num_;
 } pc_qset_t;
 
@@ -17,7 +17,15 @@ static void pd_scale( pd_t *n )
 {
   int neg = n->v_ < 0L;
   uint64_t v = neg?-n->v_:n->v_;
-  for( ;v&0xfffffffff0000000UL; v/= 10UL, ++n->e_ );
+  if ( v&0xfffffffff0000000UL ) {
+    // drop excess digits with a single divide by the smallest
+    // power of ten that brings v below 2^28
+    uint64_t m = v >> 28, d = 10UL;
+    int k = 1;
+    for( ; d <= m; d *= 10UL, ++k );
+    v /= d;
+    n->e_ += k;
+  }
   n->v_ = neg ? -v : v;
 }
 
@@ -78,7 +86,8 @@ static void pd_add( pd_t *r, pd_t *n1, pd_t *n2, const uint64_t *p )
   pd_scale( r );
 }
 
-static void pd_sub( pd_t *r, pd_t *n1, pd_t *n2, const uint64_t *p )
+// subtract without re-scaling result (sign is same as pd_sub)
+static void pd_sub_raw( pd_t *r, pd_t *n1, pd_t *n2, const uint64_t *p )
 {
   int d = n1->e_ - n2->e_;
   if ( d==0 ) {
@@ -101,42 +110,28 @@ static void pd_sub( pd_t *r, pd_t *n1, pd_t *n2, const uint64_t *p )
       pd_new( r, -n2->v_, n2->e_ );
     }
   }
+}
+
+static void pd_sub( pd_t *r, pd_t *n1, pd_t *n2, const uint64_t *p )
+{
+  pd_sub_raw( r, n1, n2, p );
   pd_scale( r );
 }
 
 static int pd_lt( pd_t *n1, pd_t *n2, const uint64_t *p )
 {
   pd_t r[1];
-  pd_sub( r, n1, n2, p );
+  pd_sub_raw( r, n1, n2, p );
   return r->v_ < 0L;
 }
 
 static int pd_gt( pd_t *n1, pd_t *n2, const uint64_t *p )
 {
   pd_t r[1];
-  pd_sub( r, n1, n2, p );
+  pd_sub_raw( r, n1, n2, p );
   return r->v_ > 0L;
 }
 
-static void pd_sqrt( pd_t *r, pd_t *val, const uint64_t *f )
-{
-  pd_t t[1], x[1], hlf[1];
-  pd_set( t, val );
-  pd_new( r, 1, 0 );
-  pd_add( x, t, r, f );
-  pd_new( hlf, 5, -1 );
-  pd_mul( x, x, hlf );
-  for(;;) {
-    pd_div( r, t, x );
-    pd_add( r, r, x, f );
-    pd_mul( r, r, hlf );
-    if ( x->v_ == r->v_ ) {
-      break;
-    }
-    pd_set( x, r );
-  }
-}
-
 // initialize quote-set temporary data in heap area
 static pc_qset_t *qset_new()
 {
@@ -191,6 +186,41 @@ static pc_qset_t *qset_new()
   qs->fact_[16]  = 10000000000000000UL;
   qs->fact_[17]  = 100000000000000000UL;
 
+  // max weight 1/sqrt(n) of n quoters as computed by pd_sqrt and pd_div
+  pd_new( &qs->wmax_[0], 0L, 0 );
+  pd_new( &qs->wmax_[1], 100000000L, -8 );
+  pd_new( &qs->wmax_[2], 70710678L, -8 );
+  pd_new( &qs->wmax_[3], 57735027L, -8 );
+  pd_new( &qs->wmax_[4], 50000000L, -8 );
+  pd_new( &qs->wmax_[5], 44721360L, -8 );
+  pd_new( &qs->wmax_[6], 40824829L, -8 );
+  pd_new( &qs->wmax_[7], 37796447L, -8 );
+  pd_new( &qs->wmax_[8], 35355339L, -8 );
+  pd_new( &qs->wmax_[9], 33333333L, -8 );
+  pd_new( &qs->wmax_[10], 31622777L, -8 );
+  pd_new( &qs->wmax_[11], 30151135L, -8 );
+  pd_new( &qs->wmax_[12], 28867513L, -8 );
+  pd_new( &qs->wmax_[13], 27735010L, -8 );
+  pd_new( &qs->wmax_[14], 267261248L, -9 );
+  pd_new( &qs->wmax_[15], 258198892L, -9 );
+  pd_new( &qs->wmax_[16], 250000000L, -9 );
+  pd_new( &qs->wmax_[17], 242535626L, -9 );
+  pd_new( &qs->wmax_[18], 235702265L, -9 );
+  pd_new( &qs->wmax_[19], 229415736L, -9 );
+  pd_new( &qs->wmax_[20], 223606800L, -9 );
+  pd_new( &qs->wmax_[21], 218217894L, -9 );
+  pd_new( &qs->wmax_[22], 213200719L, -9 );
+  pd_new( &qs->wmax_[23], 208514415L, -9 );
+  pd_new( &qs->wmax_[24], 204124148L, -9 );
+  pd_new( &qs->wmax_[25], 200000000L, -9 );
+  pd_new( &qs->wmax_[26], 196116135L, -9 );
+  pd_new( &qs->wmax_[27], 192450090L, -9 );
+  pd_new( &qs->wmax_[28], 188982237L, -9 );
+  pd_new( &qs->wmax_[29], 185695338L, -9 );
+  pd_new( &qs->wmax_[30], 182574188L, -9 );
+  pd_new( &qs->wmax_[31], 179605304L, -9 );
+  pd_new( &qs->wmax_[32], 176776696L, -9 );
+
   return qs;
 }
 
@@ -242,8 +272,16 @@ static inline void upd_twap(
 static void wgt_ptile( pd_t *res, pd_t *prices, pd_t *ptile, pc_qset_t *qs )
 {
   pd_t *cumwgt = qs->cumwgt_;
-  uint32_t i =0, num = qs->num_;
-  for( ; i != num && pd_lt( &cumwgt[i], ptile, qs->fact_ ); ++i );
+  uint32_t i = 0, num = qs->num_;
+  // binary search for first cumulative weight not below percentile
+  for( uint32_t j = num; i != j; ) {
+    uint32_t k = ( i + j ) >> 1;
+    if ( pd_lt( &cumwgt[k], ptile, qs->fact_ ) ) {
+      i = k + 1;
+    } else {
+      j = k;
+    }
+  }
   if ( i == num ) {
     pd_set( res, &prices[num-1] );
   } else if ( i == 0 ) {
@@ -259,6 +297,24 @@ static void wgt_ptile( pd_t *res, pd_t *prices, pd_t *ptile, pc_qset_t *qs )
   }
 }
 
+// stable sort of quote prices and their component indices by price.
+// insertion sort over contiguous keys: for n <= PC_COMP_SIZE it is as
+// fast as a sorting network on host and needs fewer bpf instructions
+// (see pctest/bench_qset.cpp)
+static void srt_quotes( int64_t *prc, uint32_t *idx, uint32_t num )
+{
+  for( uint32_t i = 1; i < num; ++i ) {
+    int64_t  p = prc[i];
+    uint32_t x = idx[i], j = i;
+    for( ; j > 0 && prc[j-1] > p; --j ) {
+      prc[j] = prc[j-1];
+      idx[j] = idx[j-1];
+    }
+    prc[j] = p;
+    idx[j] = x;
+  }
+}
+
 // update aggregate price
 static void upd_aggregate( pc_price_t *ptr, uint64_t slot )
 {
@@ -283,6 +339,7 @@ static void upd_aggregate( pc_price_t *ptr, uint64_t slot )
   // identify valid quotes and order them by price
   uint32_t numa = 0 ;
   uint32_t aidx[PC_COMP_SIZE];
+  int64_t  aprc[PC_COMP_SIZE];
   for( uint32_t i=0; i != ptr->num_; ++i ) {
     pc_price_comp_t *iptr = &ptr->comp_[i];
     // copy contributing price to aggregate snapshot
@@ -292,14 +349,11 @@ static void upd_aggregate( pc_price_t *ptr, uint64_t slot )
     if ( iptr->agg_.status_ == PC_STATUS_TRADING &&
          iptr->agg_.conf_ != 0UL &&
          slot_diff >= 0 && slot_diff <= PC_MAX_SEND_LATENCY ) {
-      int64_t ipx = iptr->agg_.price_;
-      uint32_t j = numa++;
-      for( ; j > 0 && ptr->comp_[aidx[j-1]].agg_.price_ > ipx; --j ) {
-        aidx[j] = aidx[j-1];
-      }
-      aidx[j] = i;
+      aprc[numa] = iptr->agg_.price_;
+      aidx[numa++] = i;
     }
   }
+  srt_quotes( aprc, aidx, numa );
 
   // zero quoters
   ptr->num_qt_ = numa;
@@ -369,9 +423,7 @@ static void upd_aggregate( pc_price_t *ptr, uint64_t slot )
   pd_t wmax[1], rnumer[1], rdenom[1], half[1], cumwgt[1];
   pd_set( rnumer, one );
   pd_new( rdenom, 0, 0 );
-  pd_new( wmax, numa, 0 );
-  pd_sqrt( wmax, wmax, qs->fact_ );
-  pd_div( wmax, one, wmax );
+  pd_set( wmax, &qs->wmax_[numa] );
   for( uint32_t i=0;i != numa; ++i ) {
     wptr = &qs->weight_[i];
     pd_div( wptr, wptr, wsum );